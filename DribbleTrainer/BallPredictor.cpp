@@ -0,0 +1,149 @@
+#include "BallPredictor.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+bool BallPhysics::Step(Vector& location, Vector& velocity, float radius, float deltaTime)
+{
+    bool bBouncedOffFloor = false;
+
+    //Gravity and air drag
+    velocity.Z += Gravity * deltaTime;
+    velocity = velocity * (1.f - Drag * deltaTime);
+
+    //Clamp to max ball speed
+    float speed = velocity.magnitude();
+    if(speed > MaxSpeed)
+    {
+        velocity = velocity * (MaxSpeed / speed);
+    }
+
+    location = location + velocity * deltaTime;
+
+    //Floor and ceiling
+    if(location.Z < radius && velocity.Z < 0)
+    {
+        location.Z = radius;
+        velocity.Z *= -Restitution;
+        bBouncedOffFloor = true;
+    }
+    if(location.Z > ArenaZ - radius && velocity.Z > 0)
+    {
+        location.Z = ArenaZ - radius;
+        velocity.Z *= -Restitution;
+    }
+
+    //Side walls
+    if(abs(location.X) > ArenaX - radius && location.X * velocity.X > 0)
+    {
+        location.X = location.X > 0 ? ArenaX - radius : -(ArenaX - radius);
+        velocity.X *= -Restitution;
+    }
+
+    //Back walls
+    if(abs(location.Y) > ArenaY - radius && location.Y * velocity.Y > 0)
+    {
+        location.Y = location.Y > 0 ? ArenaY - radius : -(ArenaY - radius);
+        velocity.Y *= -Restitution;
+    }
+
+    return bBouncedOffFloor;
+}
+
+void BallPredictor::Start()
+{
+    if(bRunning) { return; }
+
+    bRunning = true;
+    worker = std::thread(&BallPredictor::WorkerLoop, this);
+}
+
+void BallPredictor::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        bRunning = false;
+    }
+    wakeCondition.notify_one();
+
+    if(worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+void BallPredictor::SubmitInput(const PredictionInput& input)
+{
+    inputs.GetWriteBuffer() = input;
+    inputs.Publish();
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        bInputPending = true;
+    }
+    wakeCondition.notify_one();
+}
+
+const PredictionResult& BallPredictor::GetLatestResult()
+{
+    results.Update();
+    return results.GetReadBuffer();
+}
+
+void BallPredictor::WorkerLoop()
+{
+    while(true)
+    {
+        //Sleep until the game thread sends a new state. Nothing is sent while the overlays that need predictions are off
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait(lock, [this]{ return bInputPending || !bRunning; });
+            if(!bRunning) { return; }
+            bInputPending = false;
+        }
+
+        if(!inputs.Update()) { continue; }
+
+        Predict(inputs.GetReadBuffer(), results.GetWriteBuffer());
+        results.Publish();
+    }
+}
+
+void BallPredictor::Predict(const PredictionInput& input, PredictionResult& result)
+{
+    const float deltaTime = result.sampleInterval;
+    int steps = static_cast<int>(input.predictionTime * PREDICTION_TICK_RATE);
+    steps = std::max(0, std::min(steps, PREDICTION_MAX_SAMPLES));
+
+    Vector location = input.ballLocation;
+    Vector velocity = input.ballVelocity;
+
+    result.numSamples = 0;
+    result.bHasLanding = false;
+    result.closestToCarIndex = -1;
+    float closestToCarDistance = FLT_MAX;
+
+    for(int i = 0; i < steps; ++i)
+    {
+        bool bBounced = BallPhysics::Step(location, velocity, input.ballRadius, deltaTime);
+        result.locations[i] = location;
+        ++result.numSamples;
+
+        float time = deltaTime * (i + 1);
+
+        if(bBounced && !result.bHasLanding)
+        {
+            result.bHasLanding = true;
+            result.landingLocation = location;
+            result.landingTime = time;
+        }
+
+        Vector carLocation = input.carLocation + input.carVelocity * time;
+        float carDistance = (location - carLocation).magnitude();
+        if(carDistance < closestToCarDistance)
+        {
+            closestToCarDistance = carDistance;
+            result.closestToCarIndex = i;
+        }
+    }
+}
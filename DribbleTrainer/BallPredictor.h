@@ -0,0 +1,81 @@
+#pragma once
+#include "bakkesmod/wrappers/wrapperstructs.h"
+#include "TripleBuffer.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define PREDICTION_TICK_RATE   120
+#define PREDICTION_MAX_SECONDS 5
+#define PREDICTION_MAX_SAMPLES (PREDICTION_TICK_RATE * PREDICTION_MAX_SECONDS)
+
+//Simplified ball physics. Ignores goals, corners, and ramps - good enough for drawing and drill generation
+namespace BallPhysics
+{
+    constexpr float Gravity     = -650.f;
+    constexpr float Drag        = 0.0305f;
+    constexpr float MaxSpeed    = 6000.f;
+    constexpr float Restitution = 0.6f;
+    constexpr float ArenaX      = 4096.f;
+    constexpr float ArenaY      = 5120.f;
+    constexpr float ArenaZ      = 2044.f;
+
+    //Returns true if the ball bounced off the floor during this step
+    bool Step(Vector& location, Vector& velocity, float radius, float deltaTime);
+}
+
+struct PredictionInput
+{
+    Vector ballLocation;
+    Vector ballVelocity;
+    float ballRadius = 92.75f;
+    Vector carLocation;
+    Vector carVelocity;
+    float predictionTime = 0; //seconds
+};
+
+struct PredictionResult
+{
+    std::array<Vector, PREDICTION_MAX_SAMPLES> locations;
+    int numSamples = 0;
+    float sampleInterval = 1.f / PREDICTION_TICK_RATE;
+
+    //First point where the ball touches the floor
+    bool bHasLanding = false;
+    Vector landingLocation;
+    float landingTime = 0;
+
+    //Sample where the ball comes closest to the car if the car keeps its current velocity
+    int closestToCarIndex = -1;
+};
+
+class BallPredictor
+{
+    TripleBuffer<PredictionInput> inputs;
+    TripleBuffer<PredictionResult> results;
+
+    std::thread worker;
+    std::atomic<bool> bRunning{false};
+
+    //The worker sleeps here until there is a new input or it is stopped
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    bool bInputPending = false;
+
+    void WorkerLoop();
+    static void Predict(const PredictionInput& input, PredictionResult& result);
+
+public:
+    ~BallPredictor() { Stop(); }
+
+    void Start();
+    void Stop();
+
+    //Game thread. Constant cost regardless of prediction length
+    void SubmitInput(const PredictionInput& input);
+
+    //Render thread. Never waits on the worker
+    const PredictionResult& GetLatestResult();
+};
@@ -0,0 +1,27 @@
+#include "BallTrail.h"
+
+void BallTrail::Add(Vector ballOffset, float ballSpeed, float time, float maxAge)
+{
+    constexpr float sampleInterval = 1.f / TRAIL_SAMPLE_RATE;
+    if(count > 0 && time - captureTime[GetIndex(count - 1)] < sampleInterval) { return; }
+
+    //Overwrite the oldest sample if the ring is full
+    if(count == TRAIL_MAX_SAMPLES)
+    {
+        start = (start + 1) % TRAIL_MAX_SAMPLES;
+        --count;
+    }
+
+    int index = GetIndex(count);
+    offset[index] = ballOffset;
+    speed[index] = ballSpeed;
+    captureTime[index] = time;
+    ++count;
+
+    //Trim the ring to the allotted time
+    while(count > 1 && time - captureTime[start] > maxAge)
+    {
+        start = (start + 1) % TRAIL_MAX_SAMPLES;
+        --count;
+    }
+}
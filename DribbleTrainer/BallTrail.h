@@ -0,0 +1,28 @@
+#pragma once
+#include "bakkesmod/wrappers/wrapperstructs.h"
+#include <array>
+#include <cstdint>
+
+#define TRAIL_SAMPLE_RATE 120
+#define TRAIL_MAX_SECONDS 5
+#define TRAIL_MAX_SAMPLES (TRAIL_SAMPLE_RATE * TRAIL_MAX_SECONDS)
+
+//Recent ball positions relative to the car, kept in a fixed ring so recording and drawing never allocate
+struct BallTrail
+{
+    std::array<Vector, TRAIL_MAX_SAMPLES> offset; //Ball offset from the car in the car's frame. X forward, Y right, Z up
+    std::array<float, TRAIL_MAX_SAMPLES> speed;
+    std::array<float, TRAIL_MAX_SAMPLES> captureTime; //Seconds, same clock as the time passed to Add
+    int start = 0;
+    int count = 0;
+
+    //Scratch space for drawing. Refilled every frame, indexed oldest to newest
+    std::array<Vector2F, TRAIL_MAX_SAMPLES> projected;
+    std::array<uint8_t, TRAIL_MAX_SAMPLES> bVisible;
+
+    int GetIndex(int i) const { return (start + i) % TRAIL_MAX_SAMPLES; }
+    void Clear() { start = 0; count = 0; }
+
+    //Records at most TRAIL_SAMPLE_RATE samples per second and drops samples older than maxAge
+    void Add(Vector ballOffset, float ballSpeed, float time, float maxAge);
+};
@@ -0,0 +1,259 @@
+#include "CarStates.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr float dribbleRange = 300.f; //How close the ball has to be for a car to count as dribbling it
+}
+
+void CarStates::Resize(int count)
+{
+    const HitboxData& defaultHitbox = Hitboxes[static_cast<int>(HitboxType::Octane)];
+
+    address.resize(count, 0);
+    roofOffset.resize(count, Vector{defaultHitbox.offsetForward, 0, defaultHitbox.GetRoofHeight()});
+    location.resize(count);
+    velocity.resize(count);
+    angularVelocity.resize(count);
+    forward.resize(count);
+    right.resize(count);
+    up.resize(count);
+    bOnGround.resize(count, 0);
+    previousVelocity.resize(count);
+    bSmoothingStarted.resize(count, 0);
+    smoothedForward.resize(count);
+    smoothedLateral.resize(count);
+    smoothedVelocity.resize(count);
+    acceleration.resize(count);
+    resetLocation.resize(count);
+    resetVelocity.resize(count);
+    ballDistance.resize(count, 0.f);
+}
+
+bool CarStates::AssignCar(int index, uintptr_t carAddress, Vector carVelocity)
+{
+    if(address[index] == carAddress) { return false; }
+
+    //Slots are compacted when a car leaves, so the car may be further along from last frame. Slots before this one
+    //are already assigned, so only look ahead, and swap its history in so the displaced car can still be found later
+    const int count = Count();
+    for(int other = index + 1; other < count; ++other)
+    {
+        if(address[other] != carAddress) { continue; }
+
+        std::swap(address[index], address[other]);
+        std::swap(roofOffset[index], roofOffset[other]);
+        std::swap(previousVelocity[index], previousVelocity[other]);
+        std::swap(bSmoothingStarted[index], bSmoothingStarted[other]);
+        std::swap(smoothedForward[index], smoothedForward[other]);
+        std::swap(smoothedLateral[index], smoothedLateral[other]);
+        std::swap(smoothedVelocity[index], smoothedVelocity[other]);
+        return false;
+    }
+
+    address[index] = carAddress;
+    previousVelocity[index] = carVelocity;
+    bSmoothingStarted[index] = 0;
+    return true;
+}
+
+void CarStates::SetHitbox(int index, const HitboxData& hitbox)
+{
+    roofOffset[index] = Vector{hitbox.offsetForward, 0, hitbox.GetRoofHeight()};
+}
+
+namespace
+{
+    //Fraction of the way to move toward the newest value this frame. Exponential, so it doesn't depend on framerate
+    float GetSmoothingAmount(float timeConstant, float deltaTime)
+    {
+        if(timeConstant <= 0.f) { return 1.f; }
+        return 1.f - std::exp(-deltaTime / timeConstant);
+    }
+}
+
+void UpdateResetValues(CarStates& cars, float ballRadius, float deltaTime, const ResetSmoothing& smoothing)
+{
+    const float forwardAmount  = GetSmoothingAmount(smoothing.forwardTime, deltaTime);
+    const float lateralAmount  = GetSmoothingAmount(smoothing.lateralTime, deltaTime);
+    const float velocityAmount = GetSmoothingAmount(smoothing.velocityTime, deltaTime);
+
+    constexpr float maxVelocityAdjust = 100;
+    constexpr float resetClearance = 18.4f; //Gap between the roof and the ball. Matches the old fixed 150 height on an Octane
+
+    const int count = cars.Count();
+    for(int i = 0; i < count; ++i)
+    {
+        const Vector carForward = cars.forward[i];
+        const Vector carRight = cars.right[i];
+        const Vector carVelocity = cars.velocity[i];
+        const Vector carAngular = cars.angularVelocity[i];
+
+        //Calculate the acceleration from the change in velocity and time
+        Vector velocityChange = carVelocity - cars.previousVelocity[i];
+        cars.previousVelocity[i] = carVelocity;
+        Vector carAcceleration = deltaTime > 0 ? (velocityChange * 0.036f) * (1.f / deltaTime) : Vector{0, 0, 0};
+        cars.acceleration[i] = carAcceleration;
+
+        float ForwardAcceleration = Vector::dot(carForward, carAcceleration);//range -150 to 150
+
+        float speedPerc = carVelocity.magnitude() / 2300;
+        float angularPerc = std::abs(carAngular.Z) / 5.5f;
+        Vector forwardOffset = carForward * ForwardAcceleration * 4.f * speedPerc;
+        Vector rightOffset = carRight * (350.f * angularPerc * speedPerc);
+        Vector spawnOffset = {0, 0, cars.roofOffset[i].Z + ballRadius + resetClearance};
+        Vector velocityAdjust = {0, 0, 0};
+
+        if(cars.bOnGround[i])
+        {
+            // Handle spawn location when on the ground //
+
+            if(carAngular.Z > 0.f) //right turn
+            {
+                spawnOffset += rightOffset;
+            }
+            else if(carAngular.Z < 0.f) //left turn
+            {
+                spawnOffset -= rightOffset;
+            }
+
+            if(std::abs(carAngular.Z) > 0.f)
+            {
+                spawnOffset.Z *= (1 - angularPerc * .75f);
+                forwardOffset -= (forwardOffset * angularPerc);
+                forwardOffset -= (carForward * 200.f * std::min(angularPerc, 1.f) * speedPerc);
+                velocityAdjust -= (carRight * Vector::dot(carVelocity, carRight));
+                velocityAdjust /= 1.5f;
+            }
+
+            if(velocityAdjust.magnitude() > maxVelocityAdjust)
+            {
+                Vector velocityAdjustDirection = velocityAdjust;
+                velocityAdjustDirection.normalize();
+                velocityAdjust = velocityAdjustDirection * maxVelocityAdjust;
+            }
+        }
+        else
+        {
+            // Handle spawn location when in the air //
+
+            spawnOffset += (carVelocity.getNormalized() * 40 + carForward * 25);
+        }
+
+        //Reduce the forward offset amount based on the speed of the car, with a minimum forward position
+        forwardOffset -= (forwardOffset * speedPerc);
+
+        //Add some forward offset to start momentum when the car is very slow
+        float forwardOffsetPerc = (1 - speedPerc) * 1.f + speedPerc * .2f;
+        Vector slowForwardOffset = carForward * 30 * forwardOffsetPerc;
+        forwardOffset += slowForwardOffset;
+
+        //Make sure ball doesn't spawn in the ground
+        spawnOffset.Z = std::max(spawnOffset.Z, ballRadius);
+
+        //Smooth each channel separately. A new car starts at its current values so its first reset is already in place
+        Vector lateralOffset = {spawnOffset.X, spawnOffset.Y, 0};
+        if(cars.bSmoothingStarted[i])
+        {
+            cars.smoothedForward[i]  += (forwardOffset - cars.smoothedForward[i]) * forwardAmount;
+            cars.smoothedLateral[i]  += (lateralOffset - cars.smoothedLateral[i]) * lateralAmount;
+            cars.smoothedVelocity[i] += (velocityAdjust - cars.smoothedVelocity[i]) * velocityAmount;
+        }
+        else
+        {
+            cars.smoothedForward[i] = forwardOffset;
+            cars.smoothedLateral[i] = lateralOffset;
+            cars.smoothedVelocity[i] = velocityAdjust;
+            cars.bSmoothingStarted[i] = 1;
+        }
+
+        //Assign final values. Offsets are measured from the roof center, which sits forward of the pivot on most hitboxes
+        cars.resetLocation[i] = cars.smoothedForward[i] + cars.smoothedLateral[i] + carForward * cars.roofOffset[i].X;
+        cars.resetLocation[i].Z = spawnOffset.Z;
+        cars.resetVelocity[i] = cars.smoothedVelocity[i];
+    }
+}
+
+void UpdateBallDistances(CarStates& cars, Vector ballLocation)
+{
+    const int count = cars.Count();
+    for(int i = 0; i < count; ++i)
+    {
+        cars.ballDistance[i] = (ballLocation - cars.location[i]).magnitude();
+    }
+}
+
+bool IsInDribbleRange(const CarStates& cars, int index)
+{
+    if(index < 0 || index >= cars.Count()) { return false; }
+
+    return cars.ballDistance[index] < dribbleRange;
+}
+
+int SelectDribbler(const CarStates& cars, uintptr_t previousDribbler, int localCarIndex)
+{
+    const int count = cars.Count();
+    int dribblerIndex = -1;
+    for(int i = 0; i < count && previousDribbler != 0; ++i)
+    {
+        if(cars.address[i] == previousDribbler)
+        {
+            dribblerIndex = i;
+            break;
+        }
+    }
+
+    float closestDistance = dribbleRange;
+    for(int i = 0; i < count; ++i)
+    {
+        if(cars.ballDistance[i] < closestDistance)
+        {
+            closestDistance = cars.ballDistance[i];
+            dribblerIndex = i;
+        }
+    }
+
+    return dribblerIndex >= 0 ? dribblerIndex : localCarIndex;
+}
+
+bool IsFlickComplete(const CarStates& cars, int dribblerIndex, float maxFlickDistance)
+{
+    if(dribblerIndex < 0 || dribblerIndex >= cars.Count()) { return false; }
+    if(std::abs(cars.location[dribblerIndex].Y) >= 5120) { return false; }
+
+    return cars.ballDistance[dribblerIndex] > maxFlickDistance;
+}
+
+float GetDribbleLostConfidence(const CarStates& cars, int index, Vector ballLocation, Vector ballVelocity, float ballRadius)
+{
+    constexpr float gravity = 650.f;
+    constexpr float carAcceleration = 1000.f; //About what boost gives, so the car can always do at least this well
+    constexpr float contactRadius = 60.f;     //How far from the roof center the ball can come down and still stay on
+    constexpr float belowRoofMargin = 40.f;   //Leaves room for the ball to ride on the hood
+    constexpr float fallingSpeed = 50.f;
+
+    //Only judge cars on the ground. Jumps and flicks move the roof too much for a straight line guess
+    if(!cars.bOnGround[index]) { return 0; }
+
+    const Vector carLocation = cars.location[index];
+    const Vector roofOffset = cars.roofOffset[index];
+    const Vector roofCenter = carLocation + cars.forward[index] * roofOffset.X;
+    const float height = ballLocation.Z - (carLocation.Z + roofOffset.Z + ballRadius);
+
+    //Below the roof and falling. Nothing can get back under it
+    if(height < -belowRoofMargin && ballVelocity.Z < -fallingSpeed) { return 1; }
+    if(height <= 0) { return 0; }
+
+    //Time until the ball falls back to roof height. Later root of height + vz*t - g/2*t^2 = 0
+    const float vz = ballVelocity.Z;
+    const float timeToRoof = (vz + sqrtf(vz * vz + 2 * gravity * height)) / gravity;
+
+    //Where the ball comes down compared to where the roof will be if the car holds its velocity
+    const Vector offset = (ballLocation - roofCenter) + (ballVelocity - cars.velocity[index]) * timeToRoof;
+    const float miss = sqrtf(offset.X * offset.X + offset.Y * offset.Y);
+    const float reach = contactRadius + .5f * carAcceleration * timeToRoof * timeToRoof;
+    if(miss <= reach) { return 0; }
+
+    return 1 - reach / miss;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "bakkesmod/wrappers/wrapperstructs.h"
+#include "Hitboxes.h"
+#include <cstdint>
+#include <vector>
+
+//Time constants, in seconds, for smoothing each part of the reset. 0 turns smoothing off for that part
+struct ResetSmoothing
+{
+    float forwardTime = .125f;  //Acceleration and slow speed offsets along the car's forward
+    float lateralTime = .125f;  //Turning offset on the ground, velocity lead in the air
+    float velocityTime = 0.f;   //Velocity adjustment for turns
+};
+
+//Per-car state stored as parallel arrays so every car is updated in one tight loop
+//Nothing in here touches game wrappers. The plugin gathers inputs, then calls UpdateResetValues
+struct CarStates
+{
+    //Identity
+    std::vector<uintptr_t> address;
+    std::vector<Vector> roofOffset; //Center of the hitbox's roof from the pivot. X is forward, Z is up
+
+    //Inputs, gathered from the wrappers each frame
+    std::vector<Vector> location;
+    std::vector<Vector> velocity;
+    std::vector<Vector> angularVelocity;
+    std::vector<Vector> forward;
+    std::vector<Vector> right;
+    std::vector<Vector> up;
+    std::vector<uint8_t> bOnGround;
+
+    //History
+    std::vector<Vector> previousVelocity;
+    std::vector<uint8_t> bSmoothingStarted;
+    std::vector<Vector> smoothedForward;
+    std::vector<Vector> smoothedLateral;
+    std::vector<Vector> smoothedVelocity;
+
+    //Outputs
+    std::vector<Vector> acceleration;
+    std::vector<Vector> resetLocation;
+    std::vector<Vector> resetVelocity;
+    std::vector<float> ballDistance;
+
+    int Count() const { return static_cast<int>(address.size()); }
+    void Resize(int count);
+
+    //Keeps the car's history if it was in this slot or a later one last frame, otherwise starts it fresh
+    //Returns true for a new car, so the caller knows to look up its hitbox
+    bool AssignCar(int index, uintptr_t carAddress, Vector carVelocity);
+    void SetHitbox(int index, const HitboxData& hitbox);
+};
+
+//Computes acceleration, reset location and reset velocity for every car
+void UpdateResetValues(CarStates& cars, float ballRadius, float deltaTime, const ResetSmoothing& smoothing);
+
+//Distance from the ball to every car
+void UpdateBallDistances(CarStates& cars, Vector ballLocation);
+
+//True while the ball is close enough to this car to be dribbled
+bool IsInDribbleRange(const CarStates& cars, int index);
+
+//The closest car with the ball in dribbling range. Keeps the previous dribbler once the ball leaves, and falls back to the local car
+//The previous dribbler is passed by address because slots are compacted every frame and its index may now belong to another car
+int SelectDribbler(const CarStates& cars, uintptr_t previousDribbler, int localCarIndex);
+
+//True once the ball is farther than maxFlickDistance from the dribbler, as long as the dribbler isn't in a goal
+bool IsFlickComplete(const CarStates& cars, int dribblerIndex, float maxFlickDistance);
+
+//Closed-form guess at whether the ball can still come down on this car's roof
+//Returns 0 if it can, rising toward 1 the further out of reach it is
+float GetDribbleLostConfidence(const CarStates& cars, int index, Vector ballLocation, Vector ballVelocity, float ballRadius);
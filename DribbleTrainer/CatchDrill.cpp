@@ -0,0 +1,21 @@
+#include "CatchDrill.h"
+
+void CatchDrillBalls::Add(uintptr_t ballAddress, bool bWasSpawned, float ballLaunchTime, const CatchData& launch)
+{
+    address.push_back(ballAddress);
+    bSpawned.push_back(bWasSpawned);
+    bHolding.push_back(true);
+    launchTime.push_back(ballLaunchTime);
+    holdLocation.push_back(Vector{0, 0, 0});
+    launches.push_back(launch);
+}
+
+void CatchDrillBalls::Clear()
+{
+    address.clear();
+    bSpawned.clear();
+    bHolding.clear();
+    launchTime.clear();
+    holdLocation.clear();
+    launches.clear();
+}
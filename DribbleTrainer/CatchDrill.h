@@ -0,0 +1,31 @@
+#pragma once
+#include "bakkesmod/wrappers/wrapperstructs.h"
+#include <cstdint>
+#include <vector>
+
+struct CatchData
+{
+    Vector launchDirection;
+    float launchMagnitude; //range 0-1
+    Vector spreadLocation;
+
+    //Launches picked from the catch library carry their own hold position and velocity
+    bool bFromLibrary = false;
+    Vector launchOffset;
+    Vector launchVelocity;
+};
+
+//Multi-ball catch drill. Per-frame state is kept in parallel arrays so hold, countdown and draw are each one pass
+struct CatchDrillBalls
+{
+    std::vector<uintptr_t> address;
+    std::vector<uint8_t> bSpawned;    //Extra balls the drill spawned and has to remove
+    std::vector<uint8_t> bHolding;
+    std::vector<float> launchTime;    //Seconds after the drill started
+    std::vector<Vector> holdLocation;
+    std::vector<CatchData> launches;  //Only read when the ball launches
+
+    int Count() const { return static_cast<int>(address.size()); }
+    void Add(uintptr_t ballAddress, bool bWasSpawned, float ballLaunchTime, const CatchData& launch);
+    void Clear();
+};
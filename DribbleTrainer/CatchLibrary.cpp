@@ -0,0 +1,285 @@
+#include "CatchLibrary.h"
+#include "BallPredictor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+namespace
+{
+    //Launch grid. Launches are generated facing +X and rotated by a random yaw at runtime
+    constexpr float MinElevation  = 10.f; //degrees
+    constexpr float MaxElevation  = 80.f;
+    constexpr float ElevationStep = 1.f;
+    constexpr float MinSpeed      = 1000.f;
+    constexpr float MaxSpeed      = 5000.f;
+    constexpr float SpeedStep     = 100.f;
+    constexpr float SpreadRadii[] = {100.f, 200.f};
+    constexpr int SpreadDirections = 4;
+
+    //Catch model
+    constexpr float CarHeight        = 17.f;   //Car pivot height when resting on the floor
+    constexpr float BallRadius       = 92.75f;
+    constexpr float CatchHeight      = 150.f;  //Same height the dribble reset uses
+    constexpr float AerialMinHeight  = 300.f;
+    constexpr float AerialMaxHeight  = 1200.f;
+    constexpr float AerialMinTime    = 1.f;
+    constexpr float MinReactionTime  = .5f;
+    constexpr float MaxHoldHeight    = 1900.f; //Matches GetSafeHoldPosition
+    constexpr float CarAcceleration  = 1600.f; //Rough throttle + boost average
+    constexpr float CarMaxSpeed      = 2300.f;
+
+    //How far a car starting at rest can travel in the given time
+    float GetReachDistance(float time)
+    {
+        constexpr float accelTime = CarMaxSpeed / CarAcceleration;
+        if(time <= accelTime)
+        {
+            return .5f * CarAcceleration * time * time;
+        }
+        return .5f * CarAcceleration * accelTime * accelTime + CarMaxSpeed * (time - accelTime);
+    }
+
+    float GetHorizontalMagnitude(Vector vec)
+    {
+        return sqrtf(vec.X * vec.X + vec.Y * vec.Y);
+    }
+
+    void StoreVector(float (&out)[3], Vector vec)
+    {
+        out[0] = vec.X;
+        out[1] = vec.Y;
+        out[2] = vec.Z;
+    }
+
+    //Returns false if the launch cannot be caught
+    bool SimulateLaunch(Vector launchOffset, Vector spreadOffset, float speed, CatchLibraryEntry& outEntry)
+    {
+        const Vector carLocation = {0, 0, CarHeight};
+        Vector location = carLocation + launchOffset;
+        if(location.Z > MaxHoldHeight) { return false; }
+
+        Vector velocity = (carLocation + spreadOffset) - location;
+        velocity.normalize();
+        velocity = velocity * speed;
+        const Vector launchVelocity = velocity;
+
+        bool bCanAerial = false;
+        constexpr float deltaTime = 1.f / PREDICTION_TICK_RATE;
+        for(int i = 1; i <= PREDICTION_MAX_SAMPLES; ++i)
+        {
+            if(BallPhysics::Step(location, velocity, BallRadius, deltaTime)) { return false; }
+
+            float time = deltaTime * i;
+            Vector toBall = location - carLocation;
+            float horizontalDistance = GetHorizontalMagnitude(toBall);
+            float reach = GetReachDistance(time);
+
+            //Check if the ball can be met in the air on the way down
+            if(!bCanAerial && time >= AerialMinTime && toBall.Z >= AerialMinHeight && toBall.Z <= AerialMaxHeight && horizontalDistance <= reach)
+            {
+                bCanAerial = true;
+            }
+
+            //Wait for the ball to fall to roof height
+            if(velocity.Z >= 0 || toBall.Z > CatchHeight) { continue; }
+            if(time < MinReactionTime) { return false; }
+
+            bool bCanGround = horizontalDistance <= reach;
+            if(!bCanGround && !bCanAerial) { return false; }
+
+            //Difficulty is mostly how much of the car's reach the catch needs, then ball speed, then reaction time
+            float travelScore = bCanGround ? horizontalDistance / std::max(reach, 1.f) : 1.f;
+            float speedScore  = std::min(velocity.magnitude() / 3000.f, 1.f);
+            float timeScore   = 1.f - std::min(time / 3.f, 1.f);
+            //Raw score. Generate() turns this into a percentile so the buckets come out evenly filled
+            float difficulty  = .5f * travelScore + .3f * speedScore + .2f * timeScore;
+
+            outEntry.tags = 0;
+            if(bCanAerial) { outEntry.tags |= CATCH_TAG_AERIAL; }
+            if(bCanGround) { outEntry.tags |= CATCH_TAG_GROUND; }
+            if(std::abs(velocity.Z) < .5f * GetHorizontalMagnitude(velocity)) { outEntry.tags |= CATCH_TAG_FLAT; }
+
+            StoreVector(outEntry.launchOffset, launchOffset);
+            StoreVector(outEntry.launchVelocity, launchVelocity);
+            StoreVector(outEntry.targetOffset, toBall);
+            outEntry.timeToTarget = time;
+            outEntry.difficulty = difficulty;
+            return true;
+        }
+
+        return false;
+    }
+
+    int GetBucket(float difficulty)
+    {
+        int bucket = static_cast<int>(difficulty * CATCH_LIBRARY_BUCKETS);
+        return std::max(0, std::min(bucket, CATCH_LIBRARY_BUCKETS - 1));
+    }
+}
+
+bool CatchLibrary::Load(const std::string& path)
+{
+    Unload();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE) { return false; }
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(CatchLibraryHeader)))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(view == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    header = static_cast<const CatchLibraryHeader*>(view);
+    entries = reinterpret_cast<const CatchLibraryEntry*>(header + 1);
+
+    //Validate the header so a stale or truncated file can't send lookups out of bounds
+    bool bIsValid = header->magic == CATCH_LIBRARY_MAGIC && header->version == CATCH_LIBRARY_VERSION;
+    LONGLONG requiredSize = sizeof(CatchLibraryHeader) + static_cast<LONGLONG>(header->entryCount) * sizeof(CatchLibraryEntry);
+    bIsValid = bIsValid && requiredSize <= fileSize.QuadPart;
+    bIsValid = bIsValid && header->bucketStart[0] == 0 && header->bucketStart[CATCH_LIBRARY_BUCKETS] == header->entryCount;
+    for(int i = 0; bIsValid && i < CATCH_LIBRARY_BUCKETS; ++i)
+    {
+        bIsValid = header->bucketStart[i] <= header->bucketStart[i + 1];
+    }
+
+    if(!bIsValid)
+    {
+        Unload();
+        return false;
+    }
+
+    return true;
+}
+
+void CatchLibrary::Unload()
+{
+    if(header != nullptr)
+    {
+        UnmapViewOfFile(header);
+    }
+    if(mappingHandle != nullptr)
+    {
+        CloseHandle(mappingHandle);
+    }
+    if(fileHandle != nullptr)
+    {
+        CloseHandle(fileHandle);
+    }
+
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+    header = nullptr;
+    entries = nullptr;
+}
+
+const CatchLibraryEntry* CatchLibrary::GetRandomEntry(float difficulty) const
+{
+    if(!IsLoaded() || header->entryCount == 0) { return nullptr; }
+
+    //Search outward from the requested bucket for one that has entries
+    int bucket = GetBucket(difficulty);
+    for(int distance = 0; distance < CATCH_LIBRARY_BUCKETS; ++distance)
+    {
+        for(int candidate : {bucket - distance, bucket + distance})
+        {
+            if(candidate < 0 || candidate >= CATCH_LIBRARY_BUCKETS) { continue; }
+
+            uint32_t start = header->bucketStart[candidate];
+            uint32_t count = header->bucketStart[candidate + 1] - start;
+            if(count > 0)
+            {
+                return &entries[start + rand() % count];
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+int CatchLibrary::Generate(const std::string& path, float holdDistance)
+{
+    constexpr float DegToRad = 3.14159265f / 180;
+
+    //Spread targets around the car: centered, then rings ahead, behind, and to either side
+    std::vector<Vector> spreadOffsets = {Vector{0, 0, 0}};
+    for(float radius : SpreadRadii)
+    {
+        for(int i = 0; i < SpreadDirections; ++i)
+        {
+            float angle = (2.f * 3.14159265f / SpreadDirections) * i;
+            spreadOffsets.push_back(Vector{cosf(angle) * radius, sinf(angle) * radius, 0});
+        }
+    }
+
+    std::vector<CatchLibraryEntry> generated;
+    for(float elevation = MinElevation; elevation <= MaxElevation; elevation += ElevationStep)
+    {
+        Vector launchDirection = {cosf(elevation * DegToRad), 0, sinf(elevation * DegToRad)};
+        Vector launchOffset = launchDirection * holdDistance;
+
+        for(float speed = MinSpeed; speed <= MaxSpeed; speed += SpeedStep)
+        {
+            for(const Vector& spreadOffset : spreadOffsets)
+            {
+                CatchLibraryEntry entry;
+                if(SimulateLaunch(launchOffset, spreadOffset, speed, entry))
+                {
+                    generated.push_back(entry);
+                }
+            }
+        }
+    }
+
+    //Replace raw scores with their percentile and sort so each bucket is one contiguous range
+    std::sort(generated.begin(), generated.end(), [](const CatchLibraryEntry& a, const CatchLibraryEntry& b){ return a.difficulty < b.difficulty; });
+    for(size_t i = 0; i < generated.size(); ++i)
+    {
+        generated[i].difficulty = generated.size() > 1 ? static_cast<float>(i) / (generated.size() - 1) : 0.f;
+    }
+
+    CatchLibraryHeader outHeader = {};
+    outHeader.magic = CATCH_LIBRARY_MAGIC;
+    outHeader.version = CATCH_LIBRARY_VERSION;
+    outHeader.entryCount = static_cast<uint32_t>(generated.size());
+    for(const auto& entry : generated)
+    {
+        ++outHeader.bucketStart[GetBucket(entry.difficulty) + 1];
+    }
+    for(int i = 0; i < CATCH_LIBRARY_BUCKETS; ++i)
+    {
+        outHeader.bucketStart[i + 1] += outHeader.bucketStart[i];
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open()) { return -1; }
+
+    file.write(reinterpret_cast<const char*>(&outHeader), sizeof(outHeader));
+    file.write(reinterpret_cast<const char*>(generated.data()), generated.size() * sizeof(CatchLibraryEntry));
+    if(!file.good()) { return -1; }
+
+    return static_cast<int>(generated.size());
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "bakkesmod/wrappers/wrapperstructs.h"
+#include <cstdint>
+#include <string>
+
+#define CATCH_LIBRARY_MAGIC   0x4C435444 //"DTCL"
+#define CATCH_LIBRARY_VERSION 1
+#define CATCH_LIBRARY_BUCKETS 10
+
+enum CatchTags : uint32_t
+{
+    CATCH_TAG_AERIAL = 1 << 0, //High enough to be met in the air before it comes down
+    CATCH_TAG_GROUND = 1 << 1, //Reachable on the ground before it drops to roof height
+    CATCH_TAG_FLAT   = 1 << 2  //Comes in at a shallow angle, mostly horizontal
+};
+
+//File layout: header, then entries sorted by difficulty bucket
+//Entries in bucket N are [bucketStart[N], bucketStart[N+1])
+#pragma pack(push, 1)
+struct CatchLibraryHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t bucketStart[CATCH_LIBRARY_BUCKETS + 1];
+};
+
+struct CatchLibraryEntry
+{
+    float launchOffset[3];   //Hold position relative to the car
+    float launchVelocity[3]; //Relative to the car's velocity
+    float targetOffset[3];   //Where the ball drops to roof height, relative to the car
+    float timeToTarget;      //seconds
+    float difficulty;        //range 0-1
+    uint32_t tags;           //CatchTags
+};
+#pragma pack(pop)
+
+class CatchLibrary
+{
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+    const CatchLibraryHeader* header = nullptr;
+    const CatchLibraryEntry* entries = nullptr;
+
+public:
+    ~CatchLibrary() { Unload(); }
+
+    //Maps the file read-only. Nothing is parsed or copied
+    bool Load(const std::string& path);
+    void Unload();
+    bool IsLoaded() const { return header != nullptr; }
+    uint32_t GetEntryCount() const { return IsLoaded() ? header->entryCount : 0; }
+
+    //O(1) random pick from the bucket for this difficulty, falling back to the nearest non-empty bucket
+    const CatchLibraryEntry* GetRandomEntry(float difficulty) const;
+
+    //Offline generator. Simulates a grid of launches and keeps the catchable ones. Returns entry count, or -1 on failure
+    static int Generate(const std::string& path, float holdDistance);
+
+    static Vector ToVector(const float (&values)[3]) { return Vector{values[0], values[1], values[2]}; }
+};
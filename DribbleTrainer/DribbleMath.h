@@ -0,0 +1,212 @@
+#pragma once
+#include "bakkesmod/wrappers/wrapperstructs.h"
+#include <cmath>
+
+#if !defined(_M_X64) && !defined(__SSE2__)
+    #error DribbleMath requires SSE2
+#endif
+#include <emmintrin.h>
+
+//Small SSE vector/quaternion/basis kernel for the per-frame paths
+//Converts to and from the SDK's Vector, Rotator, and Quat so it can sit beside RenderingTools
+namespace DM
+{
+    constexpr float RotatorToRadians = 3.14159265f / 32768.f;
+
+    struct alignas(16) Vec3
+    {
+        __m128 v; //x, y, z, 0
+
+        Vec3() : v(_mm_setzero_ps()) {}
+        explicit Vec3(__m128 in) : v(in) {}
+        Vec3(float x, float y, float z) : v(_mm_set_ps(0.f, z, y, x)) {}
+        explicit Vec3(const Vector& in) : v(_mm_set_ps(0.f, in.Z, in.Y, in.X)) {}
+
+        Vector ToVector() const
+        {
+            alignas(16) float out[4];
+            _mm_store_ps(out, v);
+            return Vector{out[0], out[1], out[2]};
+        }
+
+        float X() const { return _mm_cvtss_f32(v); }
+        float Y() const { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))); }
+        float Z() const { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))); }
+
+        Vec3 operator+(const Vec3& other) const { return Vec3(_mm_add_ps(v, other.v)); }
+        Vec3 operator-(const Vec3& other) const { return Vec3(_mm_sub_ps(v, other.v)); }
+        Vec3 operator*(float scale) const { return Vec3(_mm_mul_ps(v, _mm_set1_ps(scale))); }
+        Vec3 operator-() const { return Vec3(_mm_sub_ps(_mm_setzero_ps(), v)); }
+    };
+
+    inline float Dot(const Vec3& a, const Vec3& b)
+    {
+        __m128 m = _mm_mul_ps(a.v, b.v);
+        __m128 y = _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z = _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 2, 2, 2));
+        return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(m, y), z));
+    }
+
+    inline Vec3 Cross(const Vec3& a, const Vec3& b)
+    {
+        //a.yzx * b.zxy - a.zxy * b.yzx
+        __m128 aYZX = _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 bYZX = _mm_shuffle_ps(b.v, b.v, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 result = _mm_sub_ps(_mm_mul_ps(a.v, bYZX), _mm_mul_ps(aYZX, b.v));
+        return Vec3(_mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1)));
+    }
+
+    inline float Length(const Vec3& a)
+    {
+        return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(Dot(a, a))));
+    }
+
+    //Returns zero for a zero vector, same as Vector::normalize
+    inline Vec3 Normalize(const Vec3& a)
+    {
+        float lengthSquared = Dot(a, a);
+        if(lengthSquared <= 0.f) { return Vec3(); }
+        return Vec3(_mm_div_ps(a.v, _mm_sqrt_ps(_mm_set1_ps(lengthSquared))));
+    }
+
+    struct alignas(16) Quaternion
+    {
+        __m128 v; //x, y, z, w
+
+        Quaternion() : v(_mm_set_ps(1.f, 0.f, 0.f, 0.f)) {}
+        Quaternion(float x, float y, float z, float w) : v(_mm_set_ps(w, z, y, x)) {}
+
+        Vec3 Vector3() const { return Vec3(_mm_and_ps(v, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)))); }
+        float W() const { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))); }
+
+        ::Quat ToQuat() const
+        {
+            alignas(16) float out[4];
+            _mm_store_ps(out, v);
+            ::Quat result;
+            result.X = out[0];
+            result.Y = out[1];
+            result.Z = out[2];
+            result.W = out[3];
+            return result;
+        }
+    };
+
+    inline Quaternion AngleAxis(float angle, const Vec3& axis)
+    {
+        Vec3 scaledAxis = Normalize(axis) * sinf(angle * .5f);
+        Quaternion result;
+        result.v = _mm_add_ps(scaledAxis.v, _mm_set_ps(cosf(angle * .5f), 0.f, 0.f, 0.f));
+        return result;
+    }
+
+    //Hamilton product. Rotating by the result rotates by b first, then a
+    inline Quaternion Multiply(const Quaternion& a, const Quaternion& b)
+    {
+        Vec3 aVec = a.Vector3();
+        Vec3 bVec = b.Vector3();
+        float aW = a.W();
+        float bW = b.W();
+
+        Vec3 vec = bVec * aW + aVec * bW + Cross(aVec, bVec);
+        Quaternion result;
+        result.v = _mm_add_ps(vec.v, _mm_set_ps(aW * bW - Dot(aVec, bVec), 0.f, 0.f, 0.f));
+        return result;
+    }
+
+    inline Vec3 Rotate(const Quaternion& q, const Vec3& a)
+    {
+        //a + 2w(q x a) + 2(q x (q x a))
+        Vec3 qVec = q.Vector3();
+        Vec3 t = Cross(qVec, a) * 2.f;
+        return a + t * q.W() + Cross(qVec, t);
+    }
+
+    //Orthonormal basis. Columns of the rotation matrix that takes local X/Y/Z to forward/right/up
+    struct alignas(16) Mat3
+    {
+        Vec3 forward;
+        Vec3 right;
+        Vec3 up;
+
+        //Same layout as Unreal's rotation matrix (yaw, then pitch, then roll)
+        static Mat3 FromRotator(const Rotator& rot)
+        {
+            const float pitch = rot.Pitch * RotatorToRadians;
+            const float yaw   = rot.Yaw   * RotatorToRadians;
+            const float roll  = rot.Roll  * RotatorToRadians;
+            const float SP = sinf(pitch), CP = cosf(pitch);
+            const float SY = sinf(yaw),   CY = cosf(yaw);
+            const float SR = sinf(roll),  CR = cosf(roll);
+
+            Mat3 result;
+            result.forward = Vec3(CP * CY, CP * SY, SP);
+            result.right   = Vec3(SR * SP * CY - CR * SY, SR * SP * SY + CR * CY, -SR * CP);
+            result.up      = Vec3(-(CR * SP * CY + SR * SY), CY * SR - CR * SP * SY, CR * CP);
+            return result;
+        }
+
+        Quaternion ToQuaternion() const
+        {
+            //Shepperd's method on the matrix whose columns are forward, right, up
+            const float m00 = forward.X(), m10 = forward.Y(), m20 = forward.Z();
+            const float m01 = right.X(),   m11 = right.Y(),   m21 = right.Z();
+            const float m02 = up.X(),      m12 = up.Y(),      m22 = up.Z();
+
+            const float trace = m00 + m11 + m22;
+            if(trace > 0.f)
+            {
+                float s = .5f / sqrtf(trace + 1.f);
+                return Quaternion((m21 - m12) * s, (m02 - m20) * s, (m10 - m01) * s, .25f / s);
+            }
+            if(m00 > m11 && m00 > m22)
+            {
+                float s = 2.f * sqrtf(1.f + m00 - m11 - m22);
+                return Quaternion(.25f * s, (m01 + m10) / s, (m02 + m20) / s, (m21 - m12) / s);
+            }
+            if(m11 > m22)
+            {
+                float s = 2.f * sqrtf(1.f + m11 - m00 - m22);
+                return Quaternion((m01 + m10) / s, .25f * s, (m12 + m21) / s, (m02 - m20) / s);
+            }
+            float s = 2.f * sqrtf(1.f + m22 - m00 - m11);
+            return Quaternion((m02 + m20) / s, (m12 + m21) / s, .25f * s, (m10 - m01) / s);
+        }
+
+        ::Quat ToQuat() const { return ToQuaternion().ToQuat(); }
+    };
+
+    //Orientation whose up axis points from "from" to "to", spun by "roll" around that axis. Replaces RT::LookAt with AXIS_UP
+    //Built like RT::LookAt: yaw toward the target, pitch the up axis onto it, then roll around it, so right stays level before the roll
+    inline Quaternion LookAtUp(const Vec3& from, const Vec3& to, float roll)
+    {
+        Vec3 direction = Normalize(to - from);
+
+        //Yaw. Straight up or down has no heading, so keep the default one
+        Vec3 right = Normalize(Vec3(-direction.Y(), direction.X(), 0.f));
+        if(Dot(right, right) <= 0.f)
+        {
+            right = Vec3(0.f, 1.f, 0.f);
+        }
+
+        //Pitch
+        Mat3 basis;
+        basis.up = direction;
+        basis.right = right;
+        basis.forward = Cross(right, direction);
+
+        //Roll
+        return Multiply(AngleAxis(roll, direction), basis.ToQuaternion());
+    }
+
+    //Forward and right flattened onto the ground plane. Replaces aligning a fresh RT::Matrix3 to the car's forward
+    inline void GetPlanarBasis(const Vec3& forward, Vec3& outForward, Vec3& outRight)
+    {
+        outForward = Normalize(Vec3(forward.X(), forward.Y(), 0.f));
+        if(Dot(outForward, outForward) <= 0.f)
+        {
+            outForward = Vec3(1.f, 0.f, 0.f);
+        }
+        outRight = Vec3(-outForward.Y(), outForward.X(), 0.f);
+    }
+}
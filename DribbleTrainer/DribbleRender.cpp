@@ -1,4 +1,7 @@
 #include "DribbleTrainer.h"
+#include <cstdio>
+
+using namespace std::chrono;
 
 void DribbleTrainer::Render(CanvasWrapper canvas)
 {
@@ -52,6 +55,12 @@ void DribbleTrainer::Render(CanvasWrapper canvas)
         }
     }
 
+    //Show the ball's recent path relative to the car
+    if(*bShowBallTrail)
+    {
+        DrawBallTrail(canvas);
+    }
+
     //Show launch countdown circle around ball
     if(preparingToLaunch)
     {
@@ -59,6 +68,24 @@ void DribbleTrainer::Render(CanvasWrapper canvas)
         DrawLaunchTarget(canvas, car, ball);
     }
 
+    //Show countdowns and targets for every ball in the catch drill
+    if(drillBalls.Count() > 0)
+    {
+        DrawCatchDrill(canvas, camera, car, ball);
+    }
+
+    //Show practice stats
+    if(*bShowStats)
+    {
+        DrawSessionStats(canvas);
+    }
+
+    //Show predicted landing point
+    if(*bShowLandingPoint)
+    {
+        DrawLandingMarker(canvas, camera, ball);
+    }
+
     //MATH HELP
     //
     //std::vector<std::string> debugString;
@@ -135,23 +162,35 @@ void DribbleTrainer::DrawFloorHeight(CanvasWrapper canvas, CarWrapper car)
 
 void DribbleTrainer::DrawSafeZone(CanvasWrapper canvas, CameraWrapper camera, CarWrapper car, BallWrapper ball)
 {
-    //Collect values
+    if(localCarIndex < 0) { return; }
+
+    //Collect values. The car's basis was already built this frame in UpdateCarStates
     Vector cameraLocation = camera.GetLocation();
     Vector ballLocation = ball.GetLocation();
-    Vector carLocation = car.GetLocation();
-    RT::Matrix3 carMat(car.GetRotation());
+    Vector carLocation = cars.location[localCarIndex];
+    Vector carForward = cars.forward[localCarIndex];
+    Vector carRight = cars.right[localCarIndex];
+    Vector carUp = cars.up[localCarIndex];
+    DM::Mat3 carBasis = {DM::Vec3(carForward), DM::Vec3(carRight), DM::Vec3(carUp)};
+
+    //The balance point is the center of the hitbox's roof, looked up when the car was assigned
+    Vector roofOffset = cars.roofOffset[localCarIndex];
+    Vector balancePoint = carLocation + carForward * roofOffset.X + carUp * roofOffset.Z;
 
     //Crosshair and center-of-balance circle
     canvas.SetColor(LinearColor{0,255,0,255});
-    RT::Line crosshairFront( carMat.forward *  5 + carLocation, carMat.forward *  50 + carLocation); crosshairFront.thickness = 2; crosshairFront.Draw(canvas);
-    RT::Line crosshairRight( carMat.right   *  5 + carLocation, carMat.right   *  50 + carLocation); crosshairRight.thickness = 2; crosshairRight.Draw(canvas);
-    RT::Line crosshairBack ( carMat.forward * -5 + carLocation, carMat.forward * -50 + carLocation); crosshairBack.thickness  = 2; crosshairBack.Draw(canvas);
-    RT::Line crosshairLeft ( carMat.right   * -5 + carLocation, carMat.right   * -50 + carLocation); crosshairLeft.thickness  = 2; crosshairLeft.Draw(canvas);
-    RT::Circle centerOfBalanceCircle(carLocation, carMat.ToQuat(), 20); centerOfBalanceCircle.lineThickness = 3; centerOfBalanceCircle.Draw(canvas, RA.frustum);
+    RT::Line crosshairFront( carForward *  5 + balancePoint, carForward *  50 + balancePoint); crosshairFront.thickness = 2; crosshairFront.Draw(canvas);
+    RT::Line crosshairRight( carRight   *  5 + balancePoint, carRight   *  50 + balancePoint); crosshairRight.thickness = 2; crosshairRight.Draw(canvas);
+    RT::Line crosshairBack ( carForward * -5 + balancePoint, carForward * -50 + balancePoint); crosshairBack.thickness  = 2; crosshairBack.Draw(canvas);
+    RT::Line crosshairLeft ( carRight   * -5 + balancePoint, carRight   * -50 + balancePoint); crosshairLeft.thickness  = 2; crosshairLeft.Draw(canvas);
+    RT::Circle centerOfBalanceCircle(balancePoint, carBasis.ToQuat(), 20); centerOfBalanceCircle.lineThickness = 3; centerOfBalanceCircle.Draw(canvas, RA.frustum);
 
     //DEVELOPMENT TESTING
     if(*bDebugMode)
     {
+        Vector ballResetLocation = cars.resetLocation[localCarIndex];
+        Vector ballResetVelocity = cars.resetVelocity[localCarIndex];
+
         //Draw the vector of the ball's reset velocity
         canvas.SetColor(LinearColor{0,100,255,255});
         RT::DrawVector(canvas, ballResetVelocity, carLocation + ballResetLocation);
@@ -171,7 +210,6 @@ void DribbleTrainer::DrawLineUnderBall(CanvasWrapper canvas, CameraWrapper camer
     Vector cameraLocation = camera.GetLocation();
     Vector ballLocation = ball.GetLocation();
     Vector carLocation = car.GetLocation();
-    RT::Matrix3 carMat(car.GetRotation());
     RT::Sphere ballSphere = RT::Sphere(ballLocation, ball.GetRadius());
 
     //Check if ball crosshair is inside frustum, or obscured by the ball itself
@@ -185,11 +223,14 @@ void DribbleTrainer::DrawLineUnderBall(CanvasWrapper canvas, CameraWrapper camer
 
     //Create ball location crosshair. Keep crosshair parallel with ground, but rotated to match car planar rotation
     float lineLength = 20;
-    Quat ZRot = RT::SingleAxisAlignment(RT::Matrix3(), carMat.forward, LookAtAxis::AXIS_FORWARD, 1).ToQuat();
-    Vector2F line1Start = canvas.ProjectF(RotateVectorWithQuat(Vector{-lineLength, 0, 0}, ZRot) + ballCrosshair);
-    Vector2F line1End   = canvas.ProjectF(RotateVectorWithQuat(Vector{ lineLength, 0, 0}, ZRot) + ballCrosshair);
-    Vector2F line2Start = canvas.ProjectF(RotateVectorWithQuat(Vector{0, -lineLength, 0}, ZRot) + ballCrosshair);
-    Vector2F line2End   = canvas.ProjectF(RotateVectorWithQuat(Vector{0,  lineLength, 0}, ZRot) + ballCrosshair);
+    DM::Vec3 planarForward, planarRight;
+    DM::GetPlanarBasis(DM::Vec3(localCarIndex >= 0 ? cars.forward[localCarIndex] : Vector{1, 0, 0}), planarForward, planarRight);
+    Vector lineForward = (planarForward * lineLength).ToVector();
+    Vector lineRight = (planarRight * lineLength).ToVector();
+    Vector2F line1Start = canvas.ProjectF(ballCrosshair - lineForward);
+    Vector2F line1End   = canvas.ProjectF(ballCrosshair + lineForward);
+    Vector2F line2Start = canvas.ProjectF(ballCrosshair - lineRight);
+    Vector2F line2End   = canvas.ProjectF(ballCrosshair + lineRight);
     RT::Circle ballCrosshairCircle(ballCrosshair, Quat(), 4.f); ballCrosshairCircle.steps = 8;
     
     //Draw ball location crosshair
@@ -227,26 +268,72 @@ void DribbleTrainer::DrawLineUnderBall(CanvasWrapper canvas, CameraWrapper camer
     canvas.DrawLine(canvas.ProjectF(ballBottom), canvas.ProjectF(ballCrosshair));
 }
 
+void DribbleTrainer::DrawBallTrail(CanvasWrapper canvas)
+{
+    const int count = ballTrail.count;
+    if(count < 2 || localCarIndex < 0) { return; }
+
+    //Project every sample once. Offsets are in the car's frame, so the trail moves and turns with it
+    const Vector carLocation = cars.location[localCarIndex];
+    const Vector carForward = cars.forward[localCarIndex];
+    const Vector carRight = cars.right[localCarIndex];
+    const Vector carUp = cars.up[localCarIndex];
+    for(int i = 0; i < count; ++i)
+    {
+        const Vector offset = ballTrail.offset[ballTrail.GetIndex(i)];
+        Vector location = carLocation + carForward * offset.X + carRight * offset.Y + carUp * offset.Z;
+        ballTrail.bVisible[i] = RA.frustum.IsInFrustum(location, 0.f);
+        if(ballTrail.bVisible[i])
+        {
+            ballTrail.projected[i] = canvas.ProjectF(location);
+        }
+    }
+
+    //Draw a line segment between each pair of visible samples. Speeds are grouped into bands so the color only changes between bands
+    constexpr int colorBands = 8;
+    constexpr float maxSpeed = 2300.f;
+    int currentBand = -1;
+    for(int i = 1; i < count; ++i)
+    {
+        if(!ballTrail.bVisible[i - 1] || !ballTrail.bVisible[i]) { continue; }
+
+        float speedPerc = min(ballTrail.speed[ballTrail.GetIndex(i)] / maxSpeed, 1.f);
+        int band = static_cast<int>(speedPerc * (colorBands - 1) + .5f);
+        if(band != currentBand)
+        {
+            currentBand = band;
+            canvas.SetColor(RT::GetPercentageColor(1.f - static_cast<float>(band) / (colorBands - 1)));
+        }
+
+        canvas.DrawLine(ballTrail.projected[i - 1], ballTrail.projected[i]);
+    }
+}
+
 void DribbleTrainer::DrawLaunchTimer(CanvasWrapper canvas, CameraWrapper camera, BallWrapper ball)
 {
     //Orient the circle so that it points at the camera. Rotate circle as timer counts down to keep it centered
     float piePercentage = 1 - (clock() - preparationStartTime) / (*preparationTime * CLOCKS_PER_SEC);
-    RT::Matrix3 directionMatrix = RT::LookAt(ball.GetLocation(), camera.GetLocation(), LookAtAxis::AXIS_UP, CONST_PI_F * -piePercentage + CONST_PI_F);
+    DrawLaunchCountdown(canvas, camera, ball.GetLocation(), ball.GetRadius(), piePercentage, nextLaunch.launchMagnitude, 40);
+}
+
+void DribbleTrainer::DrawLaunchCountdown(CanvasWrapper canvas, CameraWrapper camera, Vector location, float radius, float piePercentage, float launchMagnitude, int maxSteps)
+{
+    //Orient the circle so that it points at the camera. Rotate circle as timer counts down to keep it centered
+    DM::Quaternion direction = DM::LookAtUp(DM::Vec3(location), DM::Vec3(camera.GetLocation()), CONST_PI_F * -piePercentage + CONST_PI_F);
     
     //Determine the number of steps the circle should have to maintain visual fidelity
     constexpr int minSteps = 8;
-    constexpr int maxSteps = 40;
-    float distancePerc = RT::GetVisualDistance(canvas, RA.frustum, camera, ball.GetLocation());
+    float distancePerc = RT::GetVisualDistance(canvas, RA.frustum, camera, location);
     int calcSteps = static_cast<int>(maxSteps * distancePerc);
     
     //Create the circle
-    RT::Circle circleAroundBall(ball.GetLocation(), directionMatrix.ToQuat(), ball.GetRadius());
+    RT::Circle circleAroundBall(location, direction.ToQuat(), radius);
     circleAroundBall.lineThickness = 4;
     circleAroundBall.piePercentage = piePercentage;
     circleAroundBall.steps = max(calcSteps, minSteps);
 
     //Draw the circle. Change color based on how fast the ball will be launched
-    canvas.SetColor(RT::GetPercentageColor(1 - nextLaunch.launchMagnitude));
+    canvas.SetColor(RT::GetPercentageColor(1 - launchMagnitude));
     circleAroundBall.Draw(canvas, RA.frustum);
 }
 
@@ -254,9 +341,22 @@ void DribbleTrainer::DrawLaunchTarget(CanvasWrapper canvas, CarWrapper car, Ball
 {
     if(!(*bShowTargetLocation)) { return; }
 
-    Vector targetLocation = car.GetLocation() + nextLaunch.spreadLocation;
+    DrawTargetMarker(canvas, car.GetLocation() + nextLaunch.spreadLocation, ball.GetLocation(), 16);
 
-    RT::Line ballToTarget(targetLocation, ball.GetLocation());
+    //Draw the predicted launch path up to the point where it meets the car. Result may be a frame or two old
+    const PredictionResult& prediction = predictor.GetLatestResult();
+    int lastIndex = min(prediction.closestToCarIndex, prediction.numSamples - 1);
+    constexpr int sampleStride = 4;
+    for(int i = sampleStride; i <= lastIndex; i += sampleStride)
+    {
+        RT::Line segment(prediction.locations[i - sampleStride], prediction.locations[i]);
+        segment.Draw(canvas);
+    }
+}
+
+void DribbleTrainer::DrawTargetMarker(CanvasWrapper canvas, Vector targetLocation, Vector ballLocation, int segments)
+{
+    RT::Line ballToTarget(targetLocation, ballLocation);
     RT::Plane ground = RT::Plane(0,0,1,0);
 
     Vector newTarget = targetLocation;
@@ -267,5 +367,102 @@ void DribbleTrainer::DrawLaunchTarget(CanvasWrapper canvas, CarWrapper car, Ball
 
     canvas.SetColor(LinearColor{255,0,0,255});
     RT::Sphere sphere = RT::Sphere(newTarget, Quat(), 30);
-    sphere.Draw(canvas, RA.frustum, gameWrapper->GetCamera().GetLocation(), 16);
+    sphere.Draw(canvas, RA.frustum, gameWrapper->GetCamera().GetLocation(), segments);
+}
+
+void DribbleTrainer::DrawCatchDrill(CanvasWrapper canvas, CameraWrapper camera, CarWrapper car, BallWrapper ball)
+{
+    //Fewer circle steps once the drill has a lot of balls on screen
+    const int ballCount = drillBalls.Count();
+    const int maxSteps = ballCount >= 6 ? 16 : 40;
+    const int targetSegments = ballCount >= 6 ? 8 : 16;
+    const float radius = ball.GetRadius();
+    const Vector carLocation = car.GetLocation();
+
+    //Timed so EndCatchDrill can log what each ball count costs to draw
+    steady_clock::time_point startTime = steady_clock::now();
+    bool bDrewAny = false;
+
+    //One pass over the arrays. Only balls still being held have anything to draw
+    for(int i = 0; i < ballCount; ++i)
+    {
+        if(!drillBalls.bHolding[i]) { continue; }
+
+        bDrewAny = true;
+
+        Vector holdLocation = drillBalls.holdLocation[i];
+        float piePercentage = 1 - drillElapsedTime / max(drillBalls.launchTime[i], .01f);
+        DrawLaunchCountdown(canvas, camera, holdLocation, radius, piePercentage, drillBalls.launches[i].launchMagnitude, maxSteps);
+
+        if(*bShowTargetLocation)
+        {
+            DrawTargetMarker(canvas, carLocation + drillBalls.launches[i].spreadLocation, holdLocation, targetSegments);
+        }
+    }
+
+    if(bDrewAny)
+    {
+        drillDrawTime += duration_cast<duration<float, std::micro>>(steady_clock::now() - startTime).count();
+        ++drillDrawFrames;
+    }
+}
+
+void DribbleTrainer::DrawLandingMarker(CanvasWrapper canvas, CameraWrapper camera, BallWrapper ball)
+{
+    //Draw whichever prediction is newest. Never waits on the prediction thread
+    const PredictionResult& prediction = predictor.GetLatestResult();
+    if(!prediction.bHasLanding) { return; }
+
+    Vector landingLocation = prediction.landingLocation;
+    landingLocation.Z = 0;
+    if(!RA.frustum.IsInFrustum(landingLocation, ball.GetRadius())) { return; }
+
+    //Fade the marker in as the landing gets closer
+    float timePerc = 1.f - min(prediction.landingTime / *predictionTime, 1.f);
+    canvas.SetColor(LinearColor{255, 200, 0, 100 + 155 * timePerc});
+
+    RT::Circle landingCircle(landingLocation, Quat(), ball.GetRadius());
+    landingCircle.lineThickness = 3;
+    landingCircle.Draw(canvas, RA.frustum);
+
+    RT::Circle landingCenter(landingLocation, Quat(), 8.f);
+    landingCenter.steps = 8;
+    landingCenter.Draw(canvas, RA.frustum);
+}
+
+void DribbleTrainer::DrawSessionStats(CanvasWrapper canvas)
+{
+    Vector2 screen = canvas.GetSize();
+    Vector2 position = {20, static_cast<int>(screen.Y * .45f)};
+
+    //Format each line into the same buffer and draw it straight away
+    char buffer[128];
+    auto DrawLine = [&](const char* format, auto... values)
+    {
+        snprintf(buffer, sizeof(buffer), format, values...);
+        canvas.SetPosition(position);
+        canvas.DrawString(buffer);
+        position.Y += 16;
+    };
+
+    canvas.SetColor(LinearColor{255,255,255,255});
+    DrawLine("Balanced: %.1fs", stats.balancedTime);
+    DrawLine("Offset fwd: %.0f +/- %.0f  right: %.0f +/- %.0f", stats.forwardOffset.mean, stats.forwardOffset.StdDev(), stats.lateralOffset.mean, stats.lateralOffset.StdDev());
+    DrawLine("Dribbles: %u  avg %.1fs  touches %.1f", stats.dribbleDuration.count, stats.dribbleDuration.mean, stats.touchesPerDribble.mean);
+    DrawLine("Flicks: %u  avg %.0f KPH  peak %.0f KPH", stats.flickSpeed.count, stats.flickSpeed.mean, stats.flickSpeed.maxValue);
+    DrawLine("Catches: %u / %u", stats.catchesLanded, stats.catchesLanded + stats.catchesMissed);
+
+    //Offset distance histogram, one bar per bin
+    constexpr int barWidth = 8;
+    constexpr int maxBarHeight = 40;
+    uint32_t largestBin = max(stats.offsetDistance.GetLargestBin(), 1u);
+    position.Y += 4 + maxBarHeight;
+
+    canvas.SetColor(LinearColor{0,255,0,200});
+    for(int i = 0; i < STATS_HISTOGRAM_BINS; ++i)
+    {
+        int barHeight = static_cast<int>(maxBarHeight * (static_cast<float>(stats.offsetDistance.bins[i]) / largestBin));
+        canvas.SetPosition(Vector2{position.X + i * (barWidth + 2), position.Y - barHeight});
+        canvas.FillBox(Vector2{barWidth, barHeight});
+    }
 }
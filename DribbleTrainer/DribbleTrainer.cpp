@@ -25,6 +25,11 @@ void DribbleTrainer::onLoad()
     cvarManager->registerNotifier(NOTIFIER_RESET,        [this](std::vector<std::string> params){Reset();}, "Resets ball to dribbling position", PERMISSION_ALL);
     cvarManager->registerNotifier(NOTIFIER_LAUNCH,       [this](std::vector<std::string> params){GetNextLaunchDirection();}, "Launch the ball toward your car for catch practice", PERMISSION_ALL);
     cvarManager->registerNotifier(NOTIFIER_REQUEST_MODE, [this](std::vector<std::string> params){RequestToggle(params);}, "Launch the ball toward your car for catch practice", PERMISSION_ALL);
+    cvarManager->registerNotifier(NOTIFIER_GENERATE_LIBRARY, [this](std::vector<std::string> params){GenerateCatchLibrary();}, "Build the library of catchable launches", PERMISSION_ALL);
+    cvarManager->registerNotifier(NOTIFIER_LAUNCH_DRILL,     [this](std::vector<std::string> params){StartCatchDrill();}, "Hold several balls around your car and launch them one after another", PERMISSION_ALL);
+    cvarManager->registerNotifier(NOTIFIER_RESET_STATS,      [this](std::vector<std::string> params){stats.Reset();}, "Clear this session's practice stats", PERMISSION_ALL);
+    cvarManager->registerNotifier(NOTIFIER_RECORD_REPLAY,    [this](std::vector<std::string> params){ToggleReplayRecording();}, "Start or stop recording this session for the replay tests", PERMISSION_ALL);
+    cvarManager->registerNotifier(NOTIFIER_BENCHMARK_MATH,   [this](std::vector<std::string> params){BenchmarkMath();}, "Compare the math kernel against RenderingTools and the SDK", PERMISSION_ALL);
     
     //Sliders
     angularReduction  = std::make_shared<float>(0.f);
@@ -32,6 +37,10 @@ void DribbleTrainer::onLoad()
     maxFlickDistance  = std::make_shared<float>(0.f);
     preparationTime   = std::make_shared<float>(0.f);
     catchSpreadAmount = std::make_shared<float>(0.f);
+    catchStagger      = std::make_shared<float>(0.f);
+    catchBallCount    = std::make_shared<int>(0);
+    predictionTime    = std::make_shared<float>(0.f);
+    ballTrailLength   = std::make_shared<float>(0.f);
     cvarManager->registerCvar(CVAR_ANGULAR_REDUCTION,   "0.5",          "How much the angular velocity should be reduced on reset", true, true, 0,   true, 1).bindTo(angularReduction);
     cvarManager->registerCvar(CVAR_BALL_FLOOR_HEIGHT,   "2",            "How close the ball can get to the floor before resetting", true, true, 0,   true, 100000).bindTo(floorThreshold);
     cvarManager->registerCvar(CVAR_BALL_MAX_DISTANCE,   "1250",         "Max distance the ball can move before resetting to car",   true, true, 300, true, 100000).bindTo(maxFlickDistance);
@@ -39,6 +48,11 @@ void DribbleTrainer::onLoad()
     cvarManager->registerCvar(CVAR_CATCH_SPEED,         "(1500, 3500)", "Launch speed randomization range",     true, true, 0,  true, 5000);
     cvarManager->registerCvar(CVAR_CATCH_ANGLE,         "(15, 75)",     "Launch angle randomization range",     true, true, 10, true, 90);
     cvarManager->registerCvar(CVAR_CATCH_SPREAD,        "100",          "Random radius for ball target spread", true, true, 0,  true, 500).bindTo(catchSpreadAmount);
+    cvarManager->registerCvar(CVAR_CATCH_DIFFICULTY,    "(0, 1)",       "Catch library difficulty randomization range", true, true, 0, true, 1);
+    cvarManager->registerCvar(CVAR_CATCH_BALL_COUNT,    "3",            "Number of balls in a catch drill",     true, true, 1,  true, 8).bindTo(catchBallCount);
+    cvarManager->registerCvar(CVAR_CATCH_STAGGER,       "0.75",         "Time between launches in a catch drill", true, true, 0, true, 5).bindTo(catchStagger);
+    cvarManager->registerCvar(CVAR_PREDICTION_TIME,     "3",            "How many seconds ahead to predict the ball", true, true, 0.5f, true, PREDICTION_MAX_SECONDS).bindTo(predictionTime);
+    cvarManager->registerCvar(CVAR_BALL_TRAIL_LENGTH,   "2",            "How many seconds of ball trail to show", true, true, 0.5f, true, TRAIL_MAX_SECONDS).bindTo(ballTrailLength);
     
     //Bools
     bEnableDribbleMode  = std::make_shared<bool>(false);
@@ -47,22 +61,66 @@ void DribbleTrainer::onLoad()
     bShowFloorHeight    = std::make_shared<bool>(false);
     bLogFlickSpeed      = std::make_shared<bool>(false);
     bShowTargetLocation = std::make_shared<bool>(false);
+    bUseCatchLibrary    = std::make_shared<bool>(false);
+    bShowLandingPoint   = std::make_shared<bool>(false);
+    bShowStats          = std::make_shared<bool>(false);
+    bShowBallTrail      = std::make_shared<bool>(false);
     cvarManager->registerCvar(CVAR_TOGGLE_DRIBBLE_MODE,  "0", "Reset the ball if it falls below floor height").bindTo(bEnableDribbleMode);
     cvarManager->registerCvar(CVAR_TOGGLE_FLICKS_MODE,   "0", "Reset the ball if it goes farther than max flick distance").bindTo(bEnableFlicksMode);
     cvarManager->registerCvar(CVAR_SHOW_SAFE_ZONE,       "1", "Show where the ball should be to keep it balanced").bindTo(bShowSafeZone);
     cvarManager->registerCvar(CVAR_SHOW_FLOOR_HEIGHT,    "0", "Show where the reset threshold is for dribbling").bindTo(bShowFloorHeight);
     cvarManager->registerCvar(CVAR_LOG_FLICK_SPEED,      "1", "Save flick speed to bakkesmod.log so you can see them later").bindTo(bLogFlickSpeed);
     cvarManager->registerCvar(CVAR_SHOW_TARGET_LOCATION, "1", "Show the targeted location in Catch mode").bindTo(bShowTargetLocation);
+    cvarManager->registerCvar(CVAR_CATCH_USE_LIBRARY,    "1", "Pick catch launches from the catch library when it exists").bindTo(bUseCatchLibrary);
+    cvarManager->registerCvar(CVAR_SHOW_LANDING_POINT,   "0", "Show where the ball is predicted to land").bindTo(bShowLandingPoint);
+    cvarManager->registerCvar(CVAR_SHOW_STATS,           "0", "Show practice stats for this session").bindTo(bShowStats);
+    cvarManager->registerCvar(CVAR_SHOW_BALL_TRAIL,      "0", "Show the ball's recent path relative to your car, colored by speed").bindTo(bShowBallTrail);
+
+    //Reset smoothing
+    smoothForwardTime  = std::make_shared<float>(0.f);
+    smoothLateralTime  = std::make_shared<float>(0.f);
+    smoothVelocityTime = std::make_shared<float>(0.f);
+    cvarManager->registerCvar(CVAR_SMOOTH_FORWARD,  ".125", "Seconds of smoothing on the reset's forward offset. 0 is off", true, true, 0, true, 1).bindTo(smoothForwardTime);
+    cvarManager->registerCvar(CVAR_SMOOTH_LATERAL,  ".125", "Seconds of smoothing on the reset's turning offset. 0 is off", true, true, 0, true, 1).bindTo(smoothLateralTime);
+    cvarManager->registerCvar(CVAR_SMOOTH_VELOCITY, "0",    "Seconds of smoothing on the reset's velocity adjustment. 0 is off", true, true, 0, true, 1).bindTo(smoothVelocityTime);
+
+    //Early reset
+    bEarlyReset          = std::make_shared<bool>(false);
+    earlyResetConfidence = std::make_shared<float>(0.f);
+    cvarManager->registerCvar(CVAR_EARLY_RESET,      "0",  "In dribble mode, reset as soon as the ball can no longer land on the car").bindTo(bEarlyReset);
+    cvarManager->registerCvar(CVAR_EARLY_RESET_CONF, ".5", "How sure dribble mode must be that the ball is lost before resetting early", true, true, .05f, true, 1).bindTo(earlyResetConfidence);
 
     bDebugMode = std::make_shared<bool>(false);
     cvarManager->registerCvar(CVAR_DEBUG_MODE, "0", "Draw debug option").bindTo(bDebugMode);
 
+    predictor.Start();
+
+    //Map the catch library if it has been generated. Nothing is parsed here
+    catchLibrary.Load(GetCatchLibraryPath().string());
+
     gameWrapper->RegisterDrawable(bind(&DribbleTrainer::Render, this, std::placeholders::_1));
 
     gameWrapper->HookEvent("Function TAGame.Ball_TA.Explode", [&](std::string eventName){IsBallHidden = true;});
     gameWrapper->HookEvent("Function GameEvent_Soccar_TA.Active.StartRound", [&](std::string eventName){IsBallHidden = false;}); //Function TAGame.GameEvent_Soccar_TA.StartNewRound
+    gameWrapper->HookEventWithCaller<BallWrapper>("Function TAGame.Ball_TA.OnCarTouch", [&](BallWrapper ball, void* params, std::string eventName){OnBallTouched(params);});
+}
+void DribbleTrainer::onUnload()
+{
+    predictor.Stop();
+    if(libraryGeneration.valid())
+    {
+        //The file is still being written. Wait for it rather than unload the code it's running
+        libraryGeneration.wait();
+    }
+    catchLibrary.Unload();
+    EndCatchDrill();
+
+    //Don't lose a recording in progress
+    if(bRecordingReplay)
+    {
+        ToggleReplayRecording();
+    }
 }
-void DribbleTrainer::onUnload() {}
 
 //Utility
 bool DribbleTrainer::ShouldRun()
@@ -98,13 +156,23 @@ void DribbleTrainer::RequestToggle(std::vector<std::string> params)
 
 //Reset
 void DribbleTrainer::Reset()
+{
+    //Notifier resets always go onto the local player's car
+    Reset(localCarIndex);
+}
+
+void DribbleTrainer::Reset(int carIndex)
 {
     if(!ShouldRun()) { return; }
+    if(carIndex < 0 || carIndex >= cars.Count()) { return; }
 
     ServerWrapper server = gameWrapper->GetGameEventAsServer();
     BallWrapper ball = server.GetBall();
-    CarWrapper car = gameWrapper->GetLocalCar();
-    RT::Matrix3 carMat(car.GetRotation());
+    CarWrapper car(cars.address[carIndex]);
+    if(car.IsNull()) { return; }
+
+    Vector ballResetLocation = cars.resetLocation[carIndex];
+    Vector ballResetVelocity = cars.resetVelocity[carIndex];
     
     //Don't reset ball if reset location is inside any goal
     ArrayWrapper<GoalWrapper> goals = server.GetGoals();
@@ -118,11 +186,12 @@ void DribbleTrainer::Reset()
     //Apply angular velocity reduction
     Vector ballAngular = ball.GetAngularVelocity() * (1 - *angularReduction);
 
-    //Vector positionOffset = (carMat.forward * ballResetPosFwd) + (carMat.right * ballResetPosRight);
-    //positionOffset.Z = ballResetPosZ;
     ball.SetLocation(car.GetLocation() + ballResetLocation);
     ball.SetVelocity(car.GetVelocity() + ballResetVelocity);
     ball.SetAngularVelocity(ballAngular, false);
+    stats.AddReset();
+    timeSinceReset = 0;
+    bBallReachedDribbler = false;
 }
 
 bool DribbleTrainer::IsInGoal(GoalWrapper goal, Vector location)
@@ -145,35 +214,79 @@ void DribbleTrainer::Tick()
 {
     //Called inside the Render function
 
+    CheckCatchLibraryGeneration();
     if(!ShouldRun()) { return; }
 
     ServerWrapper server = gameWrapper->GetGameEventAsServer();
     BallWrapper ball = server.GetBall();
     CarWrapper car = gameWrapper->GetLocalCar();
 
-    //Get the ball reset position and velocity
-    GetResetValues(ball, car);
+    //Get the ball reset position and velocity for every car
+    UpdateCarStates(server, ball);
+    UpdateDribbler();
+    RecordReplayFrame(ball);
+    UpdateSessionStats(ball);
+    UpdateBallTrail(ball);
+
+    //Hand the latest state to the prediction thread
+    SubmitPredictionInput(ball, car);
 
     //DRIBBLE MODE
-    //If dribble mode is active and ball falls below threshold, reset ball
+    //If dribble mode is active and ball falls below threshold, reset ball onto whoever was dribbling it
+    //With early reset on, also reset as soon as the ball can't come back down on their roof
+    timeSinceReset += frameDeltaTime;
     if(*bEnableDribbleMode)
     {
+        //Give a fresh reset time to settle, and only trust the estimate once it has held for a few frames in a row
+        constexpr float earlyResetGraceTime = .5f;
+        constexpr int earlyResetFrames = 3;
+
+        //A ball held for a catch isn't being dribbled. Restart the grace time so the launch isn't judged either
+        bool bHoldingCatch = preparingToLaunch;
+        for(int i = 0; i < drillBalls.Count(); ++i)
+        {
+            bHoldingCatch |= drillBalls.bHolding[i] != 0;
+        }
+        if(bHoldingCatch)
+        {
+            timeSinceReset = 0;
+            bBallReachedDribbler = false;
+        }
+
+        //Only judge a ball that has come back to the dribbler. One still flying in from a launch would always look lost
+        if(timeSinceReset >= earlyResetGraceTime && IsInDribbleRange(cars, dribblerIndex))
+        {
+            bBallReachedDribbler = true;
+        }
+
         float ballHeight = ball.GetLocation().Z - (ball.GetRadius() + *floorThreshold);
-        if(ballHeight <= 0)
+        bool bDribbleLost = ballHeight <= 0;
+        if(!bDribbleLost && *bEarlyReset && bBallReachedDribbler && dribblerIndex >= 0 && timeSinceReset >= earlyResetGraceTime)
+        {
+            float lostConfidence = GetDribbleLostConfidence(cars, dribblerIndex, ball.GetLocation(), ball.GetVelocity(), ball.GetRadius());
+            lostConfidenceFrames = lostConfidence >= *earlyResetConfidence ? lostConfidenceFrames + 1 : 0;
+            bDribbleLost = lostConfidenceFrames >= earlyResetFrames;
+        }
+        else
+        {
+            lostConfidenceFrames = 0;
+        }
+
+        if(bDribbleLost)
         {
-            Reset();
+            Reset(dribblerIndex);
         }
     }
 
     //FLICK MODE
-    //If ball is farther than threshold distance, reset ball
-    if(*bEnableFlicksMode && !IsBallHidden && abs(car.GetLocation().Y) < 5120)
+    //If ball is farther than threshold distance from whoever flicked it, reset ball
+    if(*bEnableFlicksMode && !IsBallHidden)
     {
-        float flickDistance = (ball.GetLocation() - car.GetLocation()).magnitude();
-        if(flickDistance > *maxFlickDistance)
+        if(IsFlickComplete(cars, dribblerIndex, *maxFlickDistance))
         {
             int ballSpeed = static_cast<int>(ball.GetVelocity().magnitude() * 0.036f);//cms to kph
             cvarManager->log("Flick Speed: " + std::to_string(ballSpeed) + " KPH");
+            stats.AddFlick(static_cast<float>(ballSpeed));
 
             //If flick speed logging is enabled, log speed via in-game chat
             if(*bLogFlickSpeed)
@@ -182,7 +295,7 @@ void DribbleTrainer::Tick()
             }
 
             //Reset the ball
-            Reset();
+            Reset(dribblerIndex);
         }
     }
 
@@ -192,138 +305,264 @@ void DribbleTrainer::Tick()
     {
         HoldBallInLaunchPosition(ball, car);
     }
+
+    //Hold and launch every ball in the catch drill
+    if(drillBalls.Count() > 0)
+    {
+        UpdateCatchDrill(server, car);
+    }
 }
 
-void DribbleTrainer::GetResetValues(BallWrapper ball, CarWrapper car)
+void DribbleTrainer::UpdateCarStates(ServerWrapper server, BallWrapper ball)
 {
-    RT::Matrix3 carMat(car.GetRotation());
-
-    Vector carAcceleration = GetAcceleration(car);
-    Vector carVelocity = car.GetVelocity();
-    Vector carAngular = car.GetAngularVelocity();
-
-    float ForwardAcceleration = Vector::dot(carMat.forward, carAcceleration);//range -150 to 150
-
-    float speedPerc = carVelocity.magnitude() / 2300;
-    float angularPerc = abs(carAngular.Z) / 5.5f;
-    Vector forwardOffset = carMat.forward * ForwardAcceleration * 4.f * speedPerc;
-    Vector rightOffset = carMat.right * (350.f * angularPerc * speedPerc);
-    Vector spawnOffset = {0, 0, 150};
-    Vector velocityAdjust = {0, 0, 0};
-    
-    if(car.IsOnGround())
+    //Gather every car's state into the arrays, then update them all in one pass
+    ArrayWrapper<CarWrapper> serverCars = server.GetCars();
+    uintptr_t localCarAddress = gameWrapper->GetLocalCar().memory_address;
+
+    //Only grow here. Shrinking first would drop the history of cars that are about to move down a slot
+    int carCount = 0;
+    cars.Resize(max(cars.Count(), serverCars.Count()));
+    localCarIndex = -1;
+    for(int i = 0; i < serverCars.Count(); ++i)
     {
-        // Handle spawn location when on the ground //
+        CarWrapper car = serverCars.Get(i);
+        if(car.IsNull()) { continue; }
 
-        if(carAngular.Z > 0.f) //right turn
+        //The basis is built once per car per frame here, and everything else reads it from the arrays
+        DM::Mat3 carBasis = DM::Mat3::FromRotator(car.GetRotation());
+        if(cars.AssignCar(carCount, car.memory_address, car.GetVelocity()))
         {
-            spawnOffset += rightOffset;
+            cars.SetHitbox(carCount, GetHitbox(car.GetLoadoutBody()));
         }
-        else if(carAngular.Z < 0.f) //left turn
+        cars.location[carCount] = car.GetLocation();
+        cars.velocity[carCount] = car.GetVelocity();
+        cars.angularVelocity[carCount] = car.GetAngularVelocity();
+        cars.forward[carCount] = carBasis.forward.ToVector();
+        cars.right[carCount] = carBasis.right.ToVector();
+        cars.up[carCount] = carBasis.up.ToVector();
+        cars.bOnGround[carCount] = car.IsOnGround();
+
+        if(car.memory_address == localCarAddress)
         {
-            spawnOffset -= rightOffset;
+            localCarIndex = carCount;
         }
 
-        if(abs(carAngular.Z) > 0.f)
-        {
-            spawnOffset.Z *= (1 - angularPerc * .75f);
-            forwardOffset -= (forwardOffset * angularPerc);
-            forwardOffset -= (carMat.forward * 200.f * min(angularPerc, 1.f) * speedPerc);
-            velocityAdjust -= (carMat.right * Vector::dot(carVelocity, carMat.right));
-            velocityAdjust /= 1.5f;
-        }
-
-        constexpr float maxVelocityAdjust = 100;
-        if(velocityAdjust.magnitude() > maxVelocityAdjust)
-        {
-            Vector velocityAdjustDirection = velocityAdjust; 
-            velocityAdjustDirection.normalize();
-            velocityAdjust = velocityAdjustDirection * maxVelocityAdjust;
-        }
+        ++carCount;
     }
-    else
-    {
-        // Handle spawn location when in the air //
+    cars.Resize(carCount);
 
-        spawnOffset += (carVelocity.getNormalized() * 40 + carMat.forward * 25);
-    }
+    steady_clock::time_point now = steady_clock::now();
+    float deltaTime = duration_cast<duration<float>>(now - lastCarUpdateTime).count();
+    lastCarUpdateTime = now;
+    carDeltaTime = deltaTime;
 
-    //Reduce the forward offset amount based on the speed of the car, with a minimum forward position
-    forwardOffset -= (forwardOffset * speedPerc);
+    //Don't let a hitch or the first frame dump a huge step into the stats
+    frameDeltaTime = min(deltaTime, .1f);
 
-    //Add some forward offset to start momentum when the car is very slow
-    float forwardOffsetPerc = (1 - speedPerc) * 1.f + speedPerc * .2f;
-    Vector slowForwardOffset = carMat.forward * 30 * forwardOffsetPerc;
-    forwardOffset += slowForwardOffset;
+    resetSmoothing.forwardTime = *smoothForwardTime;
+    resetSmoothing.lateralTime = *smoothLateralTime;
+    resetSmoothing.velocityTime = *smoothVelocityTime;
+    UpdateResetValues(cars, ball.GetRadius(), deltaTime, resetSmoothing);
+    UpdateBallDistances(cars, ball.GetLocation());
+}
 
-    //Make sure ball doesn't spawn in the ground
-    spawnOffset.Z = max(spawnOffset.Z, ball.GetRadius());
+void DribbleTrainer::UpdateDribbler()
+{
+    dribblerIndex = SelectDribbler(cars, dribblerAddress, localCarIndex);
+    dribblerAddress = dribblerIndex >= 0 ? cars.address[dribblerIndex] : 0;
+}
 
-    //Create a buffer to hold reset values (buffer is created only once)
-    static std::vector<ResetData> FinalResetVals;
+void DribbleTrainer::UpdateSessionStats(BallWrapper ball)
+{
+    if(localCarIndex < 0) { return; }
+
+    //Ball offset from the roof center in the local car's frame, using the basis from UpdateCarStates
+    const Vector roofOffset = cars.roofOffset[localCarIndex];
+    Vector roofCenter = cars.location[localCarIndex] + cars.forward[localCarIndex] * roofOffset.X + cars.up[localCarIndex] * roofOffset.Z;
+    Vector toBall = ball.GetLocation() - roofCenter;
+    float ballForward = Vector::dot(toBall, cars.forward[localCarIndex]);
+    float ballRight   = Vector::dot(toBall, cars.right[localCarIndex]);
+    float ballUp      = Vector::dot(toBall, cars.up[localCarIndex]);
 
-    //Add reset value to buffer and trim buffer to allotted time
-    ResetData FinalResetValue = {spawnOffset + forwardOffset, steady_clock::now()};
-    FinalResetVals.push_back(FinalResetValue);
-    TrimResetDataBuffer(FinalResetVals, .25f);
+    //Balanced means sitting on or just above the roof
+    bool bBallBalanced = ballUp > 0 && ballUp < 250 && sqrtf(ballForward * ballForward + ballRight * ballRight) < 150;
+    bool bBallOnFloor = ball.GetLocation().Z - (ball.GetRadius() + *floorThreshold) <= 0;
 
-    //Assign final values to plugin member variables
-    ballResetLocation = GetResetDataBufferAverage(FinalResetVals);
-    ballResetLocation.Z = spawnOffset.Z;
-    ballResetVelocity = velocityAdjust;
+    stats.Update(frameDeltaTime, ballForward, ballRight, bBallBalanced, bBallOnFloor);
 }
 
-Vector DribbleTrainer::GetAcceleration(CarWrapper car)
+void DribbleTrainer::OnBallTouched(void* params)
 {
-    //Statics - these assignments only happen once
-    static Vector previousVelocity = car.GetVelocity();
-    static steady_clock::time_point previousTime = steady_clock::now();
+    //Ball_TA.OnCarTouch(Car_TA HitCar, byte HitType). Only the local car's touches count toward the stats
+    struct CarTouchParams
+    {
+        uintptr_t hitCar;
+        uint8_t hitType;
+    };
+    if(params == nullptr || !ShouldRun()) { return; }
 
-    //Get the change in velocity between the last frame and this frame
-    Vector velocityChange = car.GetVelocity() - previousVelocity;
-    previousVelocity = car.GetVelocity();
+    CarWrapper localCar = gameWrapper->GetLocalCar();
+    if(localCar.IsNull() || reinterpret_cast<CarTouchParams*>(params)->hitCar != localCar.memory_address) { return; }
 
-    //Get the change in time between the last frame and this frame
-    float timeChange = duration_cast<duration<float>>(steady_clock::now() - previousTime).count();
-    previousTime = steady_clock::now();
+    stats.AddTouch();
+}
 
-    //Calculate the acceleration from the change in velocity and time
-    return (velocityChange * 0.036f) * (1.f / timeChange);
+void DribbleTrainer::UpdateBallTrail(BallWrapper ball)
+{
+    //Start fresh whenever the trail is turned back on
+    if(!*bShowBallTrail || localCarIndex < 0)
+    {
+        ballTrail.Clear();
+        return;
+    }
+
+    trailTime += frameDeltaTime;
+    //Store the offset in the car's frame so the trail turns with the car when it's drawn
+    Vector toBall = ball.GetLocation() - cars.location[localCarIndex];
+    Vector localOffset = {Vector::dot(toBall, cars.forward[localCarIndex]), Vector::dot(toBall, cars.right[localCarIndex]), Vector::dot(toBall, cars.up[localCarIndex])};
+    ballTrail.Add(localOffset, ball.GetVelocity().magnitude(), trailTime, *ballTrailLength);
 }
 
-void DribbleTrainer::TrimResetDataBuffer(std::vector<ResetData>& Buffer, float MaxBufferTime)
+void DribbleTrainer::BenchmarkMath()
 {
-    //Loop until buffer is constrained to MaxBufferTime (in seconds)
-    while(true)
+    //Times the math kernel against the RenderingTools/SDK calls it replaced, and logs how far apart the results are
+    constexpr int iterations = 100000;
+    std::vector<Rotator> rotators;
+    std::vector<Vector> vectors;
+    rotators.reserve(iterations);
+    vectors.reserve(iterations);
+    for(int i = 0; i < iterations; ++i)
     {
-        auto FirstElementTime = Buffer[0].captureTime;
-        auto LastElementTime = Buffer[Buffer.size()-1].captureTime;
-        float BufferDuration = duration_cast<duration<float>>(LastElementTime - FirstElementTime).count();
-        if(BufferDuration > MaxBufferTime)
+        rotators.push_back(Rotator{rand() % 32768 - 16384, rand() % 65536 - 32768, rand() % 65536 - 32768});
+        vectors.push_back(Vector{static_cast<float>(rand() % 2000 - 1000), static_cast<float>(rand() % 2000 - 1000), static_cast<float>(rand() % 2000 - 1000)});
+    }
+
+    auto TimeIt = [](auto&& Function)
+    {
+        steady_clock::time_point startTime = steady_clock::now();
+        Function();
+        return duration_cast<duration<float, std::nano>>(steady_clock::now() - startTime).count() / iterations;
+    };
+    auto LogResult = [this](const std::string& name, float oldTime, float newTime, float maxError)
+    {
+        cvarManager->log(name + ": " + std::to_string(oldTime) + "ns -> " + std::to_string(newTime) + "ns, max difference " + std::to_string(maxError));
+    };
+
+    //Basis from rotator
+    Vector oldSum = {0, 0, 0};
+    float oldTime = TimeIt([&]()
+    {
+        for(const Rotator& rot : rotators)
         {
-            //Erase the front element of the buffer if it is too old
-            Buffer.erase(Buffer.begin());
+            RT::Matrix3 mat(rot);
+            oldSum += mat.forward + mat.right + mat.up;
         }
-        else
+    });
+    DM::Vec3 newSum;
+    float newTime = TimeIt([&]()
+    {
+        for(const Rotator& rot : rotators)
         {
-            //Buffer has successfully been constrained
-            return;
+            DM::Mat3 mat = DM::Mat3::FromRotator(rot);
+            newSum = newSum + mat.forward + mat.right + mat.up;
         }
+    });
+    float maxError = 0;
+    for(const Rotator& rot : rotators)
+    {
+        RT::Matrix3 oldMat(rot);
+        DM::Mat3 newMat = DM::Mat3::FromRotator(rot);
+        maxError = max(maxError, (oldMat.forward - newMat.forward.ToVector()).magnitude());
+        maxError = max(maxError, (oldMat.right - newMat.right.ToVector()).magnitude());
+        maxError = max(maxError, (oldMat.up - newMat.up.ToVector()).magnitude());
     }
-}
+    LogResult("Matrix3(Rotator)", oldTime, newTime, maxError);
 
-Vector DribbleTrainer::GetResetDataBufferAverage(const std::vector<ResetData>& Values)
-{
-    Vector result = 0;
-    for(const auto& resetValue : Values)
+    //Planar crosshair basis
+    oldTime = TimeIt([&]()
     {
-        result += resetValue.location;
+        for(const Vector& vec : vectors)
+        {
+            Quat ZRot = RT::SingleAxisAlignment(RT::Matrix3(), vec.getNormalized(), LookAtAxis::AXIS_FORWARD, 1).ToQuat();
+            oldSum += RotateVectorWithQuat(Vector{1, 0, 0}, ZRot) + RotateVectorWithQuat(Vector{0, 1, 0}, ZRot);
+        }
+    });
+    newTime = TimeIt([&]()
+    {
+        for(const Vector& vec : vectors)
+        {
+            DM::Vec3 planarForward, planarRight;
+            DM::GetPlanarBasis(DM::Normalize(DM::Vec3(vec)), planarForward, planarRight);
+            newSum = newSum + planarForward + planarRight;
+        }
+    });
+    maxError = 0;
+    for(const Vector& vec : vectors)
+    {
+        Quat ZRot = RT::SingleAxisAlignment(RT::Matrix3(), vec.getNormalized(), LookAtAxis::AXIS_FORWARD, 1).ToQuat();
+        DM::Vec3 planarForward, planarRight;
+        DM::GetPlanarBasis(DM::Normalize(DM::Vec3(vec)), planarForward, planarRight);
+        maxError = max(maxError, (RotateVectorWithQuat(Vector{1, 0, 0}, ZRot) - planarForward.ToVector()).magnitude());
+        maxError = max(maxError, (RotateVectorWithQuat(Vector{0, 1, 0}, ZRot) - planarRight.ToVector()).magnitude());
     }
-    result /= static_cast<float>(Values.size());
+    LogResult("SingleAxisAlignment crosshair", oldTime, newTime, maxError);
 
-    return result;
-}
+    //Countdown circle facing the camera. Vectors act as camera offsets from the ball, and the rotator yaw as the countdown roll
+    const Vector origin = {0, 0, 0};
+    auto GetRoll = [](const Rotator& rot) { return rot.Yaw * DM::RotatorToRadians; };
+    oldTime = TimeIt([&]()
+    {
+        for(int i = 0; i < iterations; ++i)
+        {
+            Quat lookAt = RT::LookAt(origin, vectors[i], LookAtAxis::AXIS_UP, GetRoll(rotators[i]));
+            oldSum += RotateVectorWithQuat(Vector{1, 0, 0}, lookAt) + RotateVectorWithQuat(Vector{0, 1, 0}, lookAt);
+        }
+    });
+    newTime = TimeIt([&]()
+    {
+        for(int i = 0; i < iterations; ++i)
+        {
+            DM::Quaternion lookAt = DM::LookAtUp(DM::Vec3(origin), DM::Vec3(vectors[i]), GetRoll(rotators[i]));
+            newSum = newSum + DM::Rotate(lookAt, DM::Vec3(1.f, 0.f, 0.f)) + DM::Rotate(lookAt, DM::Vec3(0.f, 1.f, 0.f));
+        }
+    });
+    maxError = 0;
+    for(int i = 0; i < iterations; ++i)
+    {
+        //Compare the rotated axes rather than the quaternions, since q and -q are the same orientation
+        Quat oldLookAt = RT::LookAt(origin, vectors[i], LookAtAxis::AXIS_UP, GetRoll(rotators[i]));
+        DM::Quaternion newLookAt = DM::LookAtUp(DM::Vec3(origin), DM::Vec3(vectors[i]), GetRoll(rotators[i]));
+        maxError = max(maxError, (RotateVectorWithQuat(Vector{1, 0, 0}, oldLookAt) - DM::Rotate(newLookAt, DM::Vec3(1.f, 0.f, 0.f)).ToVector()).magnitude());
+        maxError = max(maxError, (RotateVectorWithQuat(Vector{0, 1, 0}, oldLookAt) - DM::Rotate(newLookAt, DM::Vec3(0.f, 1.f, 0.f)).ToVector()).magnitude());
+        maxError = max(maxError, (RotateVectorWithQuat(Vector{0, 0, 1}, oldLookAt) - DM::Rotate(newLookAt, DM::Vec3(0.f, 0.f, 1.f)).ToVector()).magnitude());
+    }
+    LogResult("LookAt AXIS_UP", oldTime, newTime, maxError);
 
+    //Normalize
+    oldTime = TimeIt([&]()
+    {
+        for(const Vector& vec : vectors)
+        {
+            oldSum += vec.getNormalized();
+        }
+    });
+    newTime = TimeIt([&]()
+    {
+        for(const Vector& vec : vectors)
+        {
+            newSum = newSum + DM::Normalize(DM::Vec3(vec));
+        }
+    });
+    maxError = 0;
+    for(const Vector& vec : vectors)
+    {
+        maxError = max(maxError, (vec.getNormalized() - DM::Normalize(DM::Vec3(vec)).ToVector()).magnitude());
+    }
+    LogResult("Normalize", oldTime, newTime, maxError);
+
+    //Keep the sums alive so the loops aren't optimized away
+    cvarManager->log("Checksums: " + std::to_string(oldSum.magnitude()) + ", " + std::to_string(DM::Length(newSum)));
+}
 
 //Catch
 void DribbleTrainer::GetNextLaunchDirection()
@@ -353,13 +592,108 @@ void DribbleTrainer::GetNextLaunchDirection()
     //nextLaunch.launchDirection = spawnDirection;
     //nextLaunch.launchMagnitude = launchSpeed / 5000;
 
-    nextLaunch.launchDirection = GetRandomDirection(-180, 180, -cvarManager->getCvar(CVAR_CATCH_ANGLE).getFloatValue(), -cvarManager->getCvar(CVAR_CATCH_ANGLE).getFloatValue());//spawnDirection;
-    nextLaunch.launchMagnitude = cvarManager->getCvar(CVAR_CATCH_SPEED).getFloatValue() / 5000;
-    nextLaunch.spreadLocation = GetRandomDirection(-180,180,-90,90) * *catchSpreadAmount;
+    //A single launch replaces any multi-ball drill in progress
+    EndCatchDrill();
 
+    nextLaunch = GetNewLaunch(gameWrapper->GetLocalCar().GetLocation());
     PrepareToLaunch();
 }
 
+CatchData DribbleTrainer::GetNewLaunch(Vector carLocation)
+{
+    CatchData launch;
+    if(*bUseCatchLibrary && GetNextLibraryLaunch(carLocation, launch))
+    {
+        return launch;
+    }
+
+    launch.launchDirection = GetRandomDirection(-180, 180, -cvarManager->getCvar(CVAR_CATCH_ANGLE).getFloatValue(), -cvarManager->getCvar(CVAR_CATCH_ANGLE).getFloatValue());
+    launch.launchMagnitude = cvarManager->getCvar(CVAR_CATCH_SPEED).getFloatValue() / 5000;
+    launch.spreadLocation = GetRandomDirection(-180,180,-90,90) * *catchSpreadAmount;
+    launch.launchOffset = launch.launchDirection * (min(*maxFlickDistance, 2000) - 150.f);
+
+    return launch;
+}
+
+bool DribbleTrainer::GetNextLibraryLaunch(Vector carLocation, CatchData& outLaunch)
+{
+    //Library launches are only catchable from the exact hold position they were simulated from
+    //Re-pick any that GetSafeHoldPosition would move, and fall back to a random launch if none fit
+    constexpr int maxAttempts = 8;
+    const float difficulty = cvarManager->getCvar(CVAR_CATCH_DIFFICULTY).getFloatValue();
+    for(int attempt = 0; attempt < maxAttempts; ++attempt)
+    {
+        const CatchLibraryEntry* entry = catchLibrary.GetRandomEntry(difficulty);
+        if(entry == nullptr) { return false; }
+
+        //Library launches all face +X. Spin them to a random yaw since the ball physics doesn't care which way they face
+        float yaw = (static_cast<float>(rand()) / RAND_MAX) * (2.f * CONST_PI_F);
+        Quat yawRotation = RT::AngleAxisRotation(yaw, Vector{0, 0, 1});
+
+        Vector launchOffset = RotateVectorWithQuat(CatchLibrary::ToVector(entry->launchOffset), yawRotation);
+        Vector holdLocation = carLocation + launchOffset;
+        Vector safeHoldLocation = GetSafeHoldPosition(holdLocation);
+        if(safeHoldLocation.X != holdLocation.X || safeHoldLocation.Y != holdLocation.Y || safeHoldLocation.Z != holdLocation.Z) { continue; }
+
+        outLaunch.bFromLibrary = true;
+        outLaunch.launchOffset = launchOffset;
+        outLaunch.launchVelocity = RotateVectorWithQuat(CatchLibrary::ToVector(entry->launchVelocity), yawRotation);
+        outLaunch.spreadLocation = RotateVectorWithQuat(CatchLibrary::ToVector(entry->targetOffset), yawRotation);
+        outLaunch.launchDirection = outLaunch.launchOffset.getNormalized();
+        outLaunch.launchMagnitude = outLaunch.launchVelocity.magnitude() / 5000;
+        return true;
+    }
+
+    return false;
+}
+
+std::filesystem::path DribbleTrainer::GetCatchLibraryPath()
+{
+    return gameWrapper->GetDataFolder() / "DribbleTrainer" / "CatchLibrary.bin";
+}
+
+void DribbleTrainer::GenerateCatchLibrary()
+{
+    if(libraryGeneration.valid())
+    {
+        cvarManager->log("The catch library is already being generated");
+        return;
+    }
+
+    std::filesystem::path libraryPath = GetCatchLibraryPath();
+    std::error_code error;
+    std::filesystem::create_directories(libraryPath.parent_path(), error);
+
+    //The mapped view has to be released before the file can be overwritten. Launches fall back to random ones until it's reloaded
+    catchLibrary.Unload();
+
+    //Tens of thousands of simulations, so keep them off the game thread. CheckCatchLibraryGeneration picks up the result
+    std::string path = libraryPath.string();
+    float holdDistance = min(*maxFlickDistance, 2000) - 150.f;
+    libraryGeneration = std::async(std::launch::async, [path, holdDistance]()
+    {
+        return CatchLibrary::Generate(path, holdDistance);
+    });
+    cvarManager->log("Generating catch library...");
+}
+
+void DribbleTrainer::CheckCatchLibraryGeneration()
+{
+    if(!libraryGeneration.valid()) { return; }
+    if(libraryGeneration.wait_for(std::chrono::seconds(0)) != std::future_status::ready) { return; }
+
+    int entryCount = libraryGeneration.get();
+    std::string libraryPath = GetCatchLibraryPath().string();
+    if(entryCount < 0)
+    {
+        cvarManager->log("Failed to write catch library to " + libraryPath);
+        return;
+    }
+
+    catchLibrary.Load(libraryPath);
+    cvarManager->log("Generated " + std::to_string(entryCount) + " catchable launches");
+}
+
 Vector DribbleTrainer::GetRandomDirection(float minHorizontalAngle, float maxHorizontalAngle, float minVerticalAngle, float maxVerticalAngle)
 {
     // Swap mins and maxes if they are incorrect
@@ -407,6 +741,134 @@ float DribbleTrainer::GetRandomPercent(float minVal, float maxVal)
 
 }
 
+//Catch drill
+void DribbleTrainer::StartCatchDrill()
+{
+    if(!ShouldRun()) { return; }
+
+    ServerWrapper server = gameWrapper->GetGameEventAsServer();
+    BallWrapper ball = server.GetBall();
+    CarWrapper car = gameWrapper->GetLocalCar();
+
+    //Cancel any single launch and any drill that is still running
+    preparingToLaunch = false;
+    ++launchNum;
+    EndCatchDrill();
+
+    //The main ball goes first, extra balls are spawned at their hold positions
+    for(int i = 0; i < *catchBallCount; ++i)
+    {
+        CatchData launch = GetNewLaunch(car.GetLocation());
+        Vector holdLocation = GetSafeHoldPosition(car.GetLocation() + launch.launchOffset);
+        float launchTime = *preparationTime + *catchStagger * i;
+
+        if(i == 0)
+        {
+            drillBalls.Add(ball.memory_address, false, launchTime, launch);
+            continue;
+        }
+
+        BallWrapper extraBall = server.SpawnBall(holdLocation, true, false);
+        if(extraBall.IsNull()) { break; }
+        drillBalls.Add(extraBall.memory_address, true, launchTime, launch);
+    }
+
+    drillStartTime = steady_clock::now();
+    drillElapsedTime = 0;
+    drillDrawTime = 0;
+    drillDrawFrames = 0;
+}
+
+void DribbleTrainer::UpdateCatchDrill(ServerWrapper server, CarWrapper car)
+{
+    //Called in Tick
+
+    //Stop if any drill ball no longer exists, i.e. it was removed or freeplay was reset
+    ArrayWrapper<BallWrapper> gameBalls = server.GetGameBalls();
+    for(int i = 0; i < drillBalls.Count(); ++i)
+    {
+        bool bFound = false;
+        for(int j = 0; j < gameBalls.Count() && !bFound; ++j)
+        {
+            bFound = gameBalls.Get(j).memory_address == drillBalls.address[i];
+        }
+        if(!bFound)
+        {
+            drillBalls.Clear();
+            return;
+        }
+    }
+
+    drillElapsedTime = duration_cast<duration<float>>(steady_clock::now() - drillStartTime).count();
+    Vector carLocation = car.GetLocation();
+
+    //One pass over the arrays: countdown, hold position, and launch
+    bool bAnyHolding = false;
+    float lastLaunchTime = 0;
+    for(int i = 0; i < drillBalls.Count(); ++i)
+    {
+        lastLaunchTime = max(lastLaunchTime, drillBalls.launchTime[i]);
+        if(!drillBalls.bHolding[i]) { continue; }
+
+        BallWrapper drillBall(drillBalls.address[i]);
+        if(drillElapsedTime >= drillBalls.launchTime[i])
+        {
+            drillBalls.bHolding[i] = false;
+            drillBall.SetVelocity(GetLaunchVelocity(drillBalls.launches[i], drillBall.GetLocation(), car));
+
+            //Only the main ball is tracked for catch stats
+            if(!drillBalls.bSpawned[i])
+            {
+                stats.StartCatchAttempt();
+            }
+            continue;
+        }
+
+        bAnyHolding = true;
+        drillBalls.holdLocation[i] = GetSafeHoldPosition(carLocation + drillBalls.launches[i].launchOffset);
+        drillBall.SetVelocity(Vector{0,0,0});
+        drillBall.SetLocation(drillBalls.holdLocation[i]);
+    }
+
+    //Give the last ball time to arrive before cleaning up the extra balls
+    constexpr float cleanupDelay = 4.f;
+    if(!bAnyHolding && drillElapsedTime > lastLaunchTime + cleanupDelay)
+    {
+        EndCatchDrill();
+    }
+}
+
+void DribbleTrainer::EndCatchDrill()
+{
+    if(drillBalls.Count() == 0) { return; }
+
+    if(drillDrawFrames > 0)
+    {
+        cvarManager->log("Catch drill with " + std::to_string(drillBalls.Count()) + " balls: " + std::to_string(drillDrawTime / drillDrawFrames) + "us per frame to draw");
+    }
+
+    //Only remove balls that still exist in this game. Stored addresses may be stale if freeplay was left
+    ServerWrapper server = gameWrapper->GetGameEventAsServer();
+    if(!server.IsNull())
+    {
+        ArrayWrapper<BallWrapper> gameBalls = server.GetGameBalls();
+        for(int j = gameBalls.Count() - 1; j >= 0; --j)
+        {
+            BallWrapper gameBall = gameBalls.Get(j);
+            for(int i = 0; i < drillBalls.Count(); ++i)
+            {
+                if(drillBalls.bSpawned[i] && drillBalls.address[i] == gameBall.memory_address)
+                {
+                    server.RemoveBall(gameBall);
+                    break;
+                }
+            }
+        }
+    }
+
+    drillBalls.Clear();
+}
+
 void DribbleTrainer::PrepareToLaunch()
 {
     preparingToLaunch = true;
@@ -419,7 +881,7 @@ void DribbleTrainer::HoldBallInLaunchPosition(BallWrapper ball, CarWrapper car)
 {
     //Called in Tick
 
-    Vector spawnLocation = car.GetLocation() + nextLaunch.launchDirection * (min(*maxFlickDistance, 2000) - 150.f);
+    Vector spawnLocation = car.GetLocation() + nextLaunch.launchOffset;
 
     ball.SetVelocity(Vector{0,0,0});
     ball.SetLocation(GetSafeHoldPosition(spawnLocation));
@@ -498,16 +960,13 @@ void DribbleTrainer::Launch(int launchIndex)
     if(launchIndex != launchNum) { return; }
 
     preparingToLaunch = false;
+    stats.StartCatchAttempt();
 
     ServerWrapper server = gameWrapper->GetGameEventAsServer();
     BallWrapper ball = server.GetBall();
     CarWrapper car = gameWrapper->GetLocalCar();
 
-    //this is what needs to be calculated with prediction plugin code
-    Vector targetLocation = car.GetLocation() + nextLaunch.spreadLocation;
-    Vector launchDirection = targetLocation - ball.GetLocation();
-    launchDirection.normalize();
-    ball.SetVelocity(launchDirection * 5000 * nextLaunch.launchMagnitude + car.GetVelocity());
+    ball.SetVelocity(GetLaunchVelocity(nextLaunch, ball.GetLocation(), car));
 
     /*int randOffsetScale = 50;
     float randX = rand() % randOffsetScale;
@@ -516,6 +975,20 @@ void DribbleTrainer::Launch(int launchIndex)
     Vector launchAngle = CalculateLaunchAngle(ball.GetLocation(), car.GetLocation() + randOffset, 5000 * nextLaunch.launchMagnitude);*/
 }
 
+Vector DribbleTrainer::GetLaunchVelocity(const CatchData& launch, Vector ballLocation, CarWrapper car)
+{
+    if(launch.bFromLibrary)
+    {
+        return launch.launchVelocity + car.GetVelocity();
+    }
+
+    //this is what needs to be calculated with prediction plugin code
+    Vector targetLocation = car.GetLocation() + launch.spreadLocation;
+    Vector launchDirection = targetLocation - ballLocation;
+    launchDirection.normalize();
+    return launchDirection * 5000 * launch.launchMagnitude + car.GetVelocity();
+}
+
 Vector DribbleTrainer::CalculateLaunchAngle(Vector start, Vector target, float v)
 {
     //Convert 3D trajectory into 2D equation, just solving for angle to reach X coordinate
@@ -535,3 +1008,110 @@ Vector DribbleTrainer::CalculateLaunchAngle(Vector start, Vector target, float v
 
     return atanf(tanTheta);
 }
+
+
+//Prediction
+void DribbleTrainer::SubmitPredictionInput(BallWrapper ball, CarWrapper car)
+{
+    //Called in Tick. Copies a few vectors into the triple buffer, the worker thread does the rest
+
+    bool bNeedsLaunchPrediction = preparingToLaunch && *bShowTargetLocation;
+    if(!(*bShowLandingPoint) && !bNeedsLaunchPrediction) { return; }
+
+    PredictionInput input;
+    input.ballLocation = ball.GetLocation();
+    input.ballRadius = ball.GetRadius();
+    input.carLocation = car.GetLocation();
+    input.carVelocity = car.GetVelocity();
+    input.predictionTime = *predictionTime;
+
+    //While the ball is being held for a catch, predict the launch instead of the held ball
+    input.ballVelocity = preparingToLaunch ? GetLaunchVelocity(nextLaunch, ball.GetLocation(), car) : ball.GetVelocity();
+
+    predictor.SubmitInput(input);
+}
+
+//Replays
+std::filesystem::path DribbleTrainer::GetReplayFolder()
+{
+    return gameWrapper->GetDataFolder() / "DribbleTrainer" / "Replays";
+}
+
+void DribbleTrainer::ToggleReplayRecording()
+{
+    if(!bRecordingReplay)
+    {
+        replayRecording = ReplaySession();
+        replayRecording.settings.maxFlickDistance = *maxFlickDistance;
+
+        //Start every car's history fresh so a replay sees exactly what the core saw
+        cars.Resize(0);
+        dribblerIndex = -1;
+        dribblerAddress = 0;
+        bRecordingReplay = true;
+        cvarManager->log("Recording replay. Run " + std::string(NOTIFIER_RECORD_REPLAY) + " again to stop");
+        return;
+    }
+
+    bRecordingReplay = false;
+
+    std::filesystem::path folder = GetReplayFolder();
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+
+    //Name the file after the time the recording stopped
+    std::time_t currentTime = std::time(nullptr);
+    std::tm localTime;
+    localtime_s(&localTime, &currentTime);
+    char fileName[64];
+    std::strftime(fileName, sizeof(fileName), "%Y%m%d_%H%M%S.dtrp", &localTime);
+    std::filesystem::path path = folder / fileName;
+
+    if(replayRecording.Save(path.string()))
+    {
+        cvarManager->log("Saved " + std::to_string(replayRecording.frames.size()) + " frames to " + path.string());
+    }
+    else
+    {
+        cvarManager->log("Failed to write replay to " + path.string());
+    }
+
+    replayRecording = ReplaySession();
+}
+
+void DribbleTrainer::RecordReplayFrame(BallWrapper ball)
+{
+    if(!bRecordingReplay) { return; }
+
+    //Inputs exactly as UpdateCarStates gathered them, and the outputs the core produced from them
+    ReplayFrame frame = {};
+    frame.deltaTime = carDeltaTime;
+    frame.smoothing = resetSmoothing;
+    frame.ballLocation = ball.GetLocation();
+    frame.ballVelocity = ball.GetVelocity();
+    frame.ballRadius = ball.GetRadius();
+    frame.localCarIndex = localCarIndex;
+    frame.firstCar = static_cast<uint32_t>(replayRecording.cars.size());
+    frame.carCount = static_cast<uint32_t>(cars.Count());
+    frame.dribblerIndex = dribblerIndex;
+    frame.bFlickComplete = IsFlickComplete(cars, dribblerIndex, replayRecording.settings.maxFlickDistance);
+    frame.lostConfidence = dribblerIndex >= 0 ? GetDribbleLostConfidence(cars, dribblerIndex, frame.ballLocation, frame.ballVelocity, frame.ballRadius) : 0.f;
+    replayRecording.frames.push_back(frame);
+
+    for(int i = 0; i < cars.Count(); ++i)
+    {
+        ReplayCar car = {};
+        car.address = cars.address[i];
+        car.location = cars.location[i];
+        car.velocity = cars.velocity[i];
+        car.angularVelocity = cars.angularVelocity[i];
+        car.forward = cars.forward[i];
+        car.right = cars.right[i];
+        car.up = cars.up[i];
+        car.roofOffset = cars.roofOffset[i];
+        car.bOnGround = cars.bOnGround[i];
+        car.resetLocation = cars.resetLocation[i];
+        car.resetVelocity = cars.resetVelocity[i];
+        replayRecording.cars.push_back(car);
+    }
+}
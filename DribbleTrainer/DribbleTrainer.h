@@ -2,24 +2,53 @@
 #pragma comment(lib, "PluginSDK.lib")
 #include "bakkesmod/plugin/bakkesmodplugin.h"
 #include "RenderingTools.h"
+#include "BallPredictor.h"
+#include "CatchLibrary.h"
+#include "CatchDrill.h"
+#include "CarStates.h"
+#include "DribbleMath.h"
+#include "SessionStats.h"
+#include "BallTrail.h"
+#include "Replay.h"
 #include <chrono>
+#include <filesystem>
+#include <future>
 
 #define NOTIFIER_RESET            "DribbleReset"
 #define NOTIFIER_LAUNCH           "DribbleLaunch"
 #define NOTIFIER_REQUEST_MODE     "DribbleRequestModeToggle"
+#define NOTIFIER_LAUNCH_DRILL     "DribbleLaunchDrill"
+#define NOTIFIER_GENERATE_LIBRARY "DribbleGenerateCatchLibrary"
+#define NOTIFIER_RESET_STATS      "DribbleResetStats"
+#define NOTIFIER_RECORD_REPLAY    "DribbleRecordReplay"
+#define NOTIFIER_BENCHMARK_MATH   "DribbleBenchmarkMath"
 #define CVAR_ANGULAR_REDUCTION    "Dribble_AngularReduction"
+#define CVAR_SMOOTH_FORWARD       "Dribble_SmoothForward"
+#define CVAR_SMOOTH_LATERAL       "Dribble_SmoothLateral"
+#define CVAR_SMOOTH_VELOCITY      "Dribble_SmoothVelocity"
 #define CVAR_BALL_FLOOR_HEIGHT    "Dribble_BallFloorHeight"
+#define CVAR_EARLY_RESET          "Dribble_EarlyReset"
+#define CVAR_EARLY_RESET_CONF     "Dribble_EarlyResetConfidence"
 #define CVAR_BALL_MAX_DISTANCE    "Dribble_BallMaxDistance"
 #define CVAR_CATCH_PREPARATION    "Dribble_CatchPreparation"
 #define CVAR_CATCH_SPEED          "Dribble_CatchSpeed"
 #define CVAR_CATCH_ANGLE          "Dribble_CatchAngle"
 #define CVAR_CATCH_SPREAD         "Dribble_CatchSpread"
+#define CVAR_CATCH_DIFFICULTY     "Dribble_CatchDifficulty"
+#define CVAR_CATCH_USE_LIBRARY    "Dribble_CatchUseLibrary"
+#define CVAR_CATCH_BALL_COUNT     "Dribble_CatchBallCount"
+#define CVAR_CATCH_STAGGER        "Dribble_CatchStagger"
 #define CVAR_TOGGLE_DRIBBLE_MODE  "Dribble_ToggleDribbleMode"
 #define CVAR_TOGGLE_FLICKS_MODE   "Dribble_ToggleFlicksMode"
 #define CVAR_SHOW_SAFE_ZONE       "Dribble_ShowSafeZone"
 #define CVAR_SHOW_FLOOR_HEIGHT    "Dribble_ShowFloorHeight"
 #define CVAR_LOG_FLICK_SPEED      "Dribble_LogFlickSpeed"
 #define CVAR_SHOW_TARGET_LOCATION "Dribble_Show_Target_Location"
+#define CVAR_PREDICTION_TIME      "Dribble_PredictionTime"
+#define CVAR_SHOW_LANDING_POINT   "Dribble_ShowLandingPoint"
+#define CVAR_SHOW_STATS           "Dribble_ShowStats"
+#define CVAR_SHOW_BALL_TRAIL      "Dribble_ShowBallTrail"
+#define CVAR_BALL_TRAIL_LENGTH    "Dribble_BallTrailLength"
 #define CVAR_DEBUG_MODE           "Dribble_DebugMode"
 
 class DribbleTrainer : public BakkesMod::Plugin::BakkesModPlugin
@@ -31,6 +60,10 @@ class DribbleTrainer : public BakkesMod::Plugin::BakkesModPlugin
     std::shared_ptr<float> maxFlickDistance;
     std::shared_ptr<float> preparationTime;
     std::shared_ptr<float> catchSpreadAmount;
+    std::shared_ptr<float> catchStagger;
+    std::shared_ptr<int> catchBallCount;
+    std::shared_ptr<float> predictionTime;
+    std::shared_ptr<float> ballTrailLength;
 
     std::shared_ptr<bool> bEnableDribbleMode;
     std::shared_ptr<bool> bEnableFlicksMode;
@@ -38,18 +71,43 @@ class DribbleTrainer : public BakkesMod::Plugin::BakkesModPlugin
     std::shared_ptr<bool> bShowFloorHeight;
     std::shared_ptr<bool> bLogFlickSpeed;
     std::shared_ptr<bool> bShowTargetLocation;
+    std::shared_ptr<bool> bUseCatchLibrary;
+    std::shared_ptr<bool> bShowLandingPoint;
+    std::shared_ptr<bool> bShowStats;
+    std::shared_ptr<bool> bShowBallTrail;
+
+    std::shared_ptr<float> smoothForwardTime;
+    std::shared_ptr<float> smoothLateralTime;
+    std::shared_ptr<float> smoothVelocityTime;
+
+    std::shared_ptr<bool> bEarlyReset;
+    std::shared_ptr<float> earlyResetConfidence;
 
     std::shared_ptr<bool> bDebugMode;
     
     //Reset
-    struct ResetData
-    {
-        Vector location;
-        std::chrono::steady_clock::time_point captureTime;
-    };
+    CarStates cars;
+    int localCarIndex = -1;
+    int dribblerIndex = -1; //Car that last had the ball within dribbling range
+    uintptr_t dribblerAddress = 0; //Same car, carried across frames since its index can change
+    std::chrono::steady_clock::time_point lastCarUpdateTime;
+    float carDeltaTime = 0;
+    ResetSmoothing resetSmoothing;
+    float frameDeltaTime = 0;
+    float timeSinceReset = 0;
+    int lostConfidenceFrames = 0; //Consecutive frames the early reset estimate has been over the threshold
+    bool bBallReachedDribbler = false; //Ball has been in dribbling range since the last reset or catch launch
+
+    //Stats
+    SessionStats stats;
 
-    Vector ballResetVelocity;
-    Vector ballResetLocation;
+    //Trail
+    BallTrail ballTrail;
+    float trailTime = 0;
+
+    //Replays
+    bool bRecordingReplay = false;
+    ReplaySession replayRecording;
 
     bool IsBallHidden = false;
 
@@ -57,13 +115,19 @@ class DribbleTrainer : public BakkesMod::Plugin::BakkesModPlugin
     bool preparingToLaunch = false;
     int launchNum = 0;
     clock_t preparationStartTime;
-    struct CatchData
-    {
-        Vector launchDirection;
-        float launchMagnitude; //range 0-1
-        Vector spreadLocation;
-    };
     CatchData nextLaunch;
+    CatchLibrary catchLibrary;
+    std::future<int> libraryGeneration; //Entry count once the generator thread finishes, -1 if it failed
+
+    //Multi-ball catch drill
+    CatchDrillBalls drillBalls;
+    std::chrono::steady_clock::time_point drillStartTime;
+    float drillElapsedTime = 0;
+    float drillDrawTime = 0; //Microseconds spent in DrawCatchDrill on frames that drew something
+    int drillDrawFrames = 0;
+
+    //Prediction
+    BallPredictor predictor;
 
 public:
     void onLoad() override;
@@ -81,15 +145,24 @@ public:
     void DrawSafeZone(CanvasWrapper canvas, CameraWrapper camera, CarWrapper car, BallWrapper ball);
     void DrawLineUnderBall(CanvasWrapper canvas, CameraWrapper camera, CarWrapper car, BallWrapper ball);
     void DrawLaunchTimer(CanvasWrapper canvas, CameraWrapper camera, BallWrapper ball);
+    void DrawLaunchCountdown(CanvasWrapper canvas, CameraWrapper camera, Vector location, float radius, float piePercentage, float launchMagnitude, int maxSteps);
     void DrawLaunchTarget(CanvasWrapper canvas, CarWrapper car, BallWrapper ball);
+    void DrawTargetMarker(CanvasWrapper canvas, Vector targetLocation, Vector ballLocation, int segments);
+    void DrawCatchDrill(CanvasWrapper canvas, CameraWrapper camera, CarWrapper car, BallWrapper ball);
+    void DrawLandingMarker(CanvasWrapper canvas, CameraWrapper camera, BallWrapper ball);
+    void DrawSessionStats(CanvasWrapper canvas);
+    void DrawBallTrail(CanvasWrapper canvas);
 
     //Reset
     void Reset();
+    void Reset(int carIndex);
     bool IsInGoal(GoalWrapper goal, Vector location);
-    void GetResetValues(BallWrapper ball, CarWrapper car);
-    Vector GetAcceleration(CarWrapper car);
-    void TrimResetDataBuffer(std::vector<ResetData>& Buffer, float MaxBufferTime);
-    Vector GetResetDataBufferAverage(const std::vector<ResetData>& Values);
+    void UpdateCarStates(ServerWrapper server, BallWrapper ball);
+    void UpdateDribbler();
+    void UpdateSessionStats(BallWrapper ball);
+    void OnBallTouched(void* params);
+    void UpdateBallTrail(BallWrapper ball);
+    void BenchmarkMath();
 
     //Catch
     void PrepareToLaunch();
@@ -97,7 +170,26 @@ public:
     Vector GetSafeHoldPosition(Vector InLocation);
     void Launch(int launchIndex);
     void GetNextLaunchDirection();
+    CatchData GetNewLaunch(Vector carLocation);
+    bool GetNextLibraryLaunch(Vector carLocation, CatchData& outLaunch);
+    std::filesystem::path GetCatchLibraryPath();
+    void GenerateCatchLibrary();
+    void CheckCatchLibraryGeneration();
     Vector GetRandomDirection(float minHorizontalAngle, float maxHorizontalAngle, float minVerticalAngle, float maxVerticalAngle); // In radians
     float GetRandomPercent(float minVal, float maxVal); // Range 0-1
+    Vector GetLaunchVelocity(const CatchData& launch, Vector ballLocation, CarWrapper car);
     Vector CalculateLaunchAngle(Vector start, Vector target, float speed);
+
+    //Catch drill
+    void StartCatchDrill();
+    void UpdateCatchDrill(ServerWrapper server, CarWrapper car);
+    void EndCatchDrill();
+
+    //Prediction
+    void SubmitPredictionInput(BallWrapper ball, CarWrapper car);
+
+    //Replays
+    std::filesystem::path GetReplayFolder();
+    void ToggleReplayRecording();
+    void RecordReplayFrame(BallWrapper ball);
 };
@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+
+//Car hitbox sizes and offsets from the car's pivot, in unreal units. Every body uses one of these six hitboxes
+enum class HitboxType : uint8_t
+{
+    Octane,
+    Dominus,
+    Plank,
+    Breakout,
+    Hybrid,
+    Merc,
+    MAX
+};
+
+struct HitboxData
+{
+    float length;
+    float width;
+    float height;
+    float offsetForward; //Hitbox center in front of the pivot
+    float offsetUp;      //Hitbox center above the pivot
+
+    constexpr float GetRoofHeight() const { return offsetUp + height * .5f; }
+};
+
+constexpr HitboxData Hitboxes[static_cast<int>(HitboxType::MAX)] =
+{
+    //length   width   height  forward   up
+    {118.01f, 84.20f, 36.16f, 13.88f, 20.75f}, //Octane
+    {127.93f, 83.28f, 31.30f,  9.00f, 15.75f}, //Dominus
+    {128.82f, 84.67f, 29.39f,  9.01f, 12.09f}, //Plank
+    {131.49f, 80.52f, 30.30f, 12.50f, 11.75f}, //Breakout
+    {127.02f, 82.19f, 34.16f, 13.88f, 20.75f}, //Hybrid
+    {120.72f, 76.71f, 41.66f, 11.38f, 21.50f}, //Merc
+};
+
+//Body product IDs from CarWrapper::GetLoadoutBody, sorted by ID. Bodies not listed use the Octane hitbox
+struct BodyHitbox
+{
+    int bodyId;
+    HitboxType hitbox;
+};
+
+constexpr BodyHitbox BodyHitboxes[] =
+{
+    {  21, HitboxType::Octane   }, //Backfire
+    {  22, HitboxType::Breakout }, //Breakout
+    {  23, HitboxType::Octane   }, //Octane
+    {  24, HitboxType::Plank    }, //Paladin
+    {  25, HitboxType::Octane   }, //Road Hog
+    {  26, HitboxType::Octane   }, //Gizmo
+    {  28, HitboxType::Hybrid   }, //X-Devil
+    {  29, HitboxType::Dominus  }, //Hotshot
+    {  30, HitboxType::Merc     }, //Merc
+    {  31, HitboxType::Hybrid   }, //Venom
+    { 402, HitboxType::Octane   }, //Takumi
+    { 403, HitboxType::Dominus  }, //Dominus
+    { 404, HitboxType::Octane   }, //Scarab
+    { 523, HitboxType::Octane   }, //Zippy
+    { 597, HitboxType::Octane   }, //DeLorean Time Machine
+    { 600, HitboxType::Dominus  }, //Ripper
+    { 607, HitboxType::Octane   }, //Grog
+    { 625, HitboxType::Octane   }, //Armadillo
+    { 723, HitboxType::Octane   }, //Hogsticker
+    { 803, HitboxType::Plank    }, //'16 Batmobile
+    {1018, HitboxType::Dominus  }, //Dominus GT
+    {1159, HitboxType::Hybrid   }, //X-Devil Mk2
+    {1171, HitboxType::Dominus  }, //Masamune
+    {1172, HitboxType::Octane   }, //Marauder
+    {1286, HitboxType::Dominus  }, //Aftershock
+    {1295, HitboxType::Octane   }, //Takumi RX-T
+    {1300, HitboxType::Hybrid   }, //Esper
+    {1317, HitboxType::Hybrid   }, //Endo
+    {1416, HitboxType::Breakout }, //Breakout Type-S
+    {1533, HitboxType::Octane   }, //Vulcan
+    {1568, HitboxType::Octane   }, //Octane ZSR
+    {1623, HitboxType::Octane   }, //Bone Shaker
+    {1691, HitboxType::Plank    }, //Mantis
+    {1856, HitboxType::Hybrid   }, //Jager 619
+    {1919, HitboxType::Plank    }, //Centio
+    {2269, HitboxType::Breakout }, //Animus GP
+    {2298, HitboxType::Breakout }, //Samurai
+    {2853, HitboxType::Dominus  }, //Peregrine TT
+    {2950, HitboxType::Octane   }, //Fennec
+    {3031, HitboxType::Breakout }, //Cyclone
+};
+
+constexpr bool IsBodyTableSorted()
+{
+    for(int i = 1; i < static_cast<int>(sizeof(BodyHitboxes) / sizeof(BodyHitboxes[0])); ++i)
+    {
+        if(BodyHitboxes[i - 1].bodyId >= BodyHitboxes[i].bodyId) { return false; }
+    }
+    return true;
+}
+static_assert(IsBodyTableSorted(), "BodyHitboxes must be sorted by body ID");
+
+//Binary search of the body table. Only called when a car changes, never per frame
+constexpr const HitboxData& GetHitbox(int bodyId)
+{
+    int low = 0;
+    int high = static_cast<int>(sizeof(BodyHitboxes) / sizeof(BodyHitboxes[0])) - 1;
+    while(low <= high)
+    {
+        int mid = (low + high) / 2;
+        if(BodyHitboxes[mid].bodyId == bodyId) { return Hitboxes[static_cast<int>(BodyHitboxes[mid].hitbox)]; }
+        if(BodyHitboxes[mid].bodyId < bodyId) { low = mid + 1; }
+        else { high = mid - 1; }
+    }
+    return Hitboxes[static_cast<int>(HitboxType::Octane)];
+}
+
+static_assert(GetHitbox(1018).height == Hitboxes[static_cast<int>(HitboxType::Dominus)].height, "Body lookup is broken");
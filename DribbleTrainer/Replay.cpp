@@ -0,0 +1,193 @@
+#include "Replay.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+using namespace std::chrono;
+
+bool ReplaySession::Load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open()) { return false; }
+
+    ReplayHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!file.good() || header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION) { return false; }
+
+    settings = header.settings;
+    frames.resize(header.frameCount);
+    cars.resize(header.carCount);
+    file.read(reinterpret_cast<char*>(frames.data()), frames.size() * sizeof(ReplayFrame));
+    file.read(reinterpret_cast<char*>(cars.data()), cars.size() * sizeof(ReplayCar));
+    if(!file.good()) { return false; }
+
+    //Don't trust the car ranges blindly
+    for(const auto& frame : frames)
+    {
+        if(static_cast<uint64_t>(frame.firstCar) + frame.carCount > cars.size()) { return false; }
+    }
+
+    return true;
+}
+
+bool ReplaySession::Save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open()) { return false; }
+
+    ReplayHeader header;
+    header.magic = REPLAY_MAGIC;
+    header.version = REPLAY_VERSION;
+    header.settings = settings;
+    header.frameCount = static_cast<uint32_t>(frames.size());
+    header.carCount = static_cast<uint32_t>(cars.size());
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(frames.data()), frames.size() * sizeof(ReplayFrame));
+    file.write(reinterpret_cast<const char*>(cars.data()), cars.size() * sizeof(ReplayCar));
+    return file.good();
+}
+
+const char* GetReplayStageName(ReplayStage stage)
+{
+    switch(stage)
+    {
+        case ReplayStage::ResetValues:    return "ResetValues";
+        case ReplayStage::BallDistances:  return "BallDistances";
+        case ReplayStage::Dribbler:       return "Dribbler";
+        case ReplayStage::LostConfidence: return "LostConfidence";
+        default:                          return "Unknown";
+    }
+}
+
+namespace
+{
+    bool IsNear(const Vector& a, const Vector& b, float tolerance)
+    {
+        return std::abs(a.X - b.X) <= tolerance && std::abs(a.Y - b.Y) <= tolerance && std::abs(a.Z - b.Z) <= tolerance;
+    }
+
+    std::string ToString(const Vector& vec)
+    {
+        return "(" + std::to_string(vec.X) + ", " + std::to_string(vec.Y) + ", " + std::to_string(vec.Z) + ")";
+    }
+}
+
+ReplayResult RunReplay(ReplaySession& session, float tolerance, bool bUpdateGolden)
+{
+    ReplayResult result;
+    result.bLoaded = true;
+    result.frameCount = static_cast<int>(session.frames.size());
+    for(auto& times : result.stageTimes)
+    {
+        times.reserve(session.frames.size());
+    }
+
+    auto AddMismatch = [&result](int frameIndex, const std::string& description)
+    {
+        if(result.mismatchCount++ == 0)
+        {
+            result.firstMismatch = "frame " + std::to_string(frameIndex) + ": " + description;
+        }
+    };
+
+    auto AddStageTime = [&result](ReplayStage stage, steady_clock::time_point start, steady_clock::time_point end)
+    {
+        result.stageTimes[static_cast<int>(stage)].push_back(duration_cast<duration<float, std::micro>>(end - start).count());
+    };
+
+    //Same order of calls as the plugin's Tick
+    CarStates cars;
+    int dribblerIndex = -1;
+    uintptr_t dribblerAddress = 0;
+    for(int frameIndex = 0; frameIndex < result.frameCount; ++frameIndex)
+    {
+        ReplayFrame& frame = session.frames[frameIndex];
+        ReplayCar* frameCars = session.cars.data() + frame.firstCar;
+        const int carCount = static_cast<int>(frame.carCount);
+
+        cars.Resize(std::max(cars.Count(), carCount));
+        for(int i = 0; i < carCount; ++i)
+        {
+            const ReplayCar& car = frameCars[i];
+            cars.AssignCar(i, static_cast<uintptr_t>(car.address), car.velocity);
+            cars.roofOffset[i] = car.roofOffset;
+            cars.location[i] = car.location;
+            cars.velocity[i] = car.velocity;
+            cars.angularVelocity[i] = car.angularVelocity;
+            cars.forward[i] = car.forward;
+            cars.right[i] = car.right;
+            cars.up[i] = car.up;
+            cars.bOnGround[i] = car.bOnGround;
+        }
+        cars.Resize(carCount);
+        const int localCarIndex = frame.localCarIndex < carCount ? frame.localCarIndex : -1;
+
+        steady_clock::time_point start = steady_clock::now();
+        UpdateResetValues(cars, frame.ballRadius, frame.deltaTime, frame.smoothing);
+        steady_clock::time_point resetTime = steady_clock::now();
+        UpdateBallDistances(cars, frame.ballLocation);
+        steady_clock::time_point distanceTime = steady_clock::now();
+        dribblerIndex = SelectDribbler(cars, dribblerAddress, localCarIndex);
+        dribblerAddress = dribblerIndex >= 0 ? cars.address[dribblerIndex] : 0;
+        bool bFlickComplete = IsFlickComplete(cars, dribblerIndex, session.settings.maxFlickDistance);
+        steady_clock::time_point dribblerTime = steady_clock::now();
+        float lostConfidence = dribblerIndex >= 0 ? GetDribbleLostConfidence(cars, dribblerIndex, frame.ballLocation, frame.ballVelocity, frame.ballRadius) : 0.f;
+        steady_clock::time_point lostTime = steady_clock::now();
+
+        AddStageTime(ReplayStage::ResetValues,    start,        resetTime);
+        AddStageTime(ReplayStage::BallDistances,  resetTime,    distanceTime);
+        AddStageTime(ReplayStage::Dribbler,       distanceTime, dribblerTime);
+        AddStageTime(ReplayStage::LostConfidence, dribblerTime, lostTime);
+
+        if(bUpdateGolden)
+        {
+            for(int i = 0; i < carCount; ++i)
+            {
+                frameCars[i].resetLocation = cars.resetLocation[i];
+                frameCars[i].resetVelocity = cars.resetVelocity[i];
+            }
+            frame.dribblerIndex = dribblerIndex;
+            frame.bFlickComplete = bFlickComplete;
+            frame.lostConfidence = lostConfidence;
+            continue;
+        }
+
+        //Compare against the recorded outputs
+        for(int i = 0; i < carCount; ++i)
+        {
+            if(!IsNear(cars.resetLocation[i], frameCars[i].resetLocation, tolerance))
+            {
+                AddMismatch(frameIndex, "car " + std::to_string(i) + " reset location " + ToString(cars.resetLocation[i]) + " expected " + ToString(frameCars[i].resetLocation));
+            }
+            if(!IsNear(cars.resetVelocity[i], frameCars[i].resetVelocity, tolerance))
+            {
+                AddMismatch(frameIndex, "car " + std::to_string(i) + " reset velocity " + ToString(cars.resetVelocity[i]) + " expected " + ToString(frameCars[i].resetVelocity));
+            }
+        }
+        if(dribblerIndex != frame.dribblerIndex)
+        {
+            AddMismatch(frameIndex, "dribbler " + std::to_string(dribblerIndex) + " expected " + std::to_string(frame.dribblerIndex));
+        }
+        if(bFlickComplete != (frame.bFlickComplete != 0))
+        {
+            AddMismatch(frameIndex, std::string("flick ") + (bFlickComplete ? "detected" : "missed"));
+        }
+        if(std::abs(lostConfidence - frame.lostConfidence) > tolerance)
+        {
+            AddMismatch(frameIndex, "lost confidence " + std::to_string(lostConfidence) + " expected " + std::to_string(frame.lostConfidence));
+        }
+    }
+
+    return result;
+}
+
+float GetPercentile(std::vector<float>& samples, float percentile)
+{
+    if(samples.empty()) { return 0; }
+
+    size_t index = std::min(static_cast<size_t>(percentile * samples.size()), samples.size() - 1);
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "bakkesmod/wrappers/wrapperstructs.h"
+#include "CarStates.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define REPLAY_MAGIC   0x50525444 //"DTRP"
+#define REPLAY_VERSION 2
+
+//Recorded sessions for regression testing the headless core (CarStates and friends)
+//Each frame stores the inputs that were fed to the core plus the outputs it produced, which act as the golden values
+
+//File layout: header, then every frame, then every car of every frame
+#pragma pack(push, 1)
+struct ReplaySettings
+{
+    float maxFlickDistance;
+};
+
+struct ReplayHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    ReplaySettings settings;
+    uint32_t frameCount;
+    uint32_t carCount;
+};
+
+struct ReplayFrame
+{
+    //Inputs
+    float deltaTime;
+    ResetSmoothing smoothing;
+    Vector ballLocation;
+    Vector ballVelocity;
+    float ballRadius;
+    int32_t localCarIndex;
+    uint32_t firstCar;
+    uint32_t carCount;
+
+    //Outputs
+    int32_t dribblerIndex;
+    uint8_t bFlickComplete;
+    float lostConfidence;
+};
+
+struct ReplayCar
+{
+    //Inputs
+    uint64_t address;
+    Vector location;
+    Vector velocity;
+    Vector angularVelocity;
+    Vector forward;
+    Vector right;
+    Vector up;
+    Vector roofOffset;
+    uint8_t bOnGround;
+
+    //Outputs
+    Vector resetLocation;
+    Vector resetVelocity;
+};
+#pragma pack(pop)
+
+struct ReplaySession
+{
+    ReplaySettings settings = {};
+    std::vector<ReplayFrame> frames;
+    std::vector<ReplayCar> cars;
+
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+};
+
+//Stages of the core that are timed during a replay
+enum class ReplayStage
+{
+    ResetValues,
+    BallDistances,
+    Dribbler,
+    LostConfidence,
+    MAX
+};
+
+const char* GetReplayStageName(ReplayStage stage);
+
+struct ReplayResult
+{
+    std::string name;
+    bool bLoaded = false;
+    int frameCount = 0;
+    int mismatchCount = 0;
+    std::string firstMismatch;
+    std::vector<float> stageTimes[static_cast<int>(ReplayStage::MAX)]; //Microseconds per frame
+};
+
+//Runs every frame of the session through the core and compares against the recorded outputs
+//If bUpdateGolden is true, the session's outputs are overwritten with the new ones instead
+ReplayResult RunReplay(ReplaySession& session, float tolerance, bool bUpdateGolden);
+
+//Partially sorts the samples in place
+float GetPercentile(std::vector<float>& samples, float percentile);
@@ -0,0 +1,138 @@
+#include "SessionStats.h"
+#include <algorithm>
+#include <cmath>
+
+//RunningStat
+void RunningStat::Add(float value)
+{
+    ++count;
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+
+    minValue = count == 1 ? value : std::min(minValue, value);
+    maxValue = count == 1 ? value : std::max(maxValue, value);
+}
+
+float RunningStat::StdDev() const
+{
+    if(count < 2) { return 0; }
+    return static_cast<float>(sqrt(m2 / (count - 1)));
+}
+
+//FixedHistogram
+void FixedHistogram::Add(float value)
+{
+    float percent = (value - minValue) / (maxValue - minValue);
+    int bin = static_cast<int>(percent * STATS_HISTOGRAM_BINS);
+    bin = std::max(0, std::min(bin, STATS_HISTOGRAM_BINS - 1));
+
+    ++bins[bin];
+    ++total;
+}
+
+uint32_t FixedHistogram::GetLargestBin() const
+{
+    return *std::max_element(bins, bins + STATS_HISTOGRAM_BINS);
+}
+
+//SessionStats
+void SessionStats::Update(float deltaTime, float ballForward, float ballRight, bool bBallBalanced, bool bBallOnFloor)
+{
+    //Allow short pops off the roof without ending the dribble
+    constexpr float dribbleGraceTime = .5f;
+
+    //A catch counts once the ball has stayed balanced for this long
+    constexpr float catchHoldTime = .5f;
+
+    if(bBallBalanced)
+    {
+        balancedTime += deltaTime;
+        timeSinceBalanced = 0;
+
+        forwardOffset.Add(ballForward);
+        lateralOffset.Add(ballRight);
+        offsetDistance.Add(sqrtf(ballForward * ballForward + ballRight * ballRight));
+
+        if(!bDribbling)
+        {
+            bDribbling = true;
+            currentDribbleTime = 0;
+            currentTouches = 0;
+        }
+    }
+    else
+    {
+        timeSinceBalanced += deltaTime;
+    }
+
+    if(bDribbling)
+    {
+        currentDribbleTime += deltaTime;
+        if(bBallOnFloor || timeSinceBalanced > dribbleGraceTime)
+        {
+            EndDribble();
+        }
+    }
+
+    if(bAwaitingCatch)
+    {
+        catchBalanceTime = bBallBalanced ? catchBalanceTime + deltaTime : 0;
+        if(catchBalanceTime >= catchHoldTime)
+        {
+            ++catchesLanded;
+            bAwaitingCatch = false;
+        }
+        else if(bBallOnFloor)
+        {
+            ++catchesMissed;
+            bAwaitingCatch = false;
+        }
+    }
+}
+
+void SessionStats::EndDribble()
+{
+    bDribbling = false;
+    dribbleDuration.Add(currentDribbleTime - timeSinceBalanced);
+    touchesPerDribble.Add(static_cast<float>(currentTouches));
+}
+
+void SessionStats::AddTouch()
+{
+    if(bDribbling)
+    {
+        ++currentTouches;
+    }
+}
+
+void SessionStats::AddFlick(float speed)
+{
+    flickSpeed.Add(speed);
+}
+
+void SessionStats::AddReset()
+{
+    //The ball was moved back onto the car, so whatever was happening before is over
+    if(bDribbling)
+    {
+        EndDribble();
+    }
+    if(bAwaitingCatch)
+    {
+        ++catchesMissed;
+        bAwaitingCatch = false;
+    }
+}
+
+void SessionStats::StartCatchAttempt()
+{
+    //A launch while the last one is still in the air counts the last one as missed
+    if(bAwaitingCatch)
+    {
+        ++catchesMissed;
+    }
+
+    bAwaitingCatch = true;
+    catchBalanceTime = 0;
+}
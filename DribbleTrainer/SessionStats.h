@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+
+#define STATS_HISTOGRAM_BINS 12
+
+//Single-pass mean and variance (Welford). Constant memory no matter how many samples are added
+struct RunningStat
+{
+    uint32_t count = 0;
+    double mean = 0;
+    double m2 = 0;
+    float minValue = 0;
+    float maxValue = 0;
+
+    void Add(float value);
+    float StdDev() const;
+};
+
+//Fixed-range histogram. Values outside the range land in the first or last bin
+struct FixedHistogram
+{
+    float minValue = 0;
+    float maxValue = 1;
+    uint32_t bins[STATS_HISTOGRAM_BINS] = {};
+    uint32_t total = 0;
+
+    void Add(float value);
+    uint32_t GetLargestBin() const;
+};
+
+//Practice statistics for the current session. Every update is a handful of arithmetic operations
+class SessionStats
+{
+public:
+    //Balance
+    float balancedTime = 0;
+    RunningStat forwardOffset;
+    RunningStat lateralOffset;
+    FixedHistogram offsetDistance{0, 120}; //Ball center distance from the roof center, 10uu per bin
+
+    //Dribbles
+    RunningStat dribbleDuration;
+    RunningStat touchesPerDribble;
+
+    //Flicks
+    RunningStat flickSpeed;
+
+    //Catches
+    uint32_t catchesLanded = 0;
+    uint32_t catchesMissed = 0;
+
+private:
+    bool bDribbling = false;
+    float currentDribbleTime = 0;
+    float timeSinceBalanced = 0;
+    uint32_t currentTouches = 0;
+
+    bool bAwaitingCatch = false;
+    float catchBalanceTime = 0;
+
+    void EndDribble();
+
+public:
+    void Reset() { *this = SessionStats(); }
+
+    //Called once per frame with the ball's offset from the roof center in the car's frame
+    void Update(float deltaTime, float ballForward, float ballRight, bool bBallBalanced, bool bBallOnFloor);
+    void AddTouch();
+    void AddFlick(float speed);
+    void AddReset();
+    void StartCatchAttempt();
+};
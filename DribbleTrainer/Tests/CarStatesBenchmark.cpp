@@ -0,0 +1,51 @@
+#include "CarStates.h"
+#include <chrono>
+#include <cstdio>
+
+//Times UpdateResetValues for 1 to 8 cars, to check that the cost per car stays flat as the lobby fills
+//Not part of ctest. Run it on the machine you care about and compare the per car column between counts
+//Usage: CarStatesBenchmark
+
+using namespace std::chrono;
+
+int main()
+{
+    constexpr int maxCars = 8;
+    constexpr int frames = 100000;
+    constexpr float deltaTime = 1.f / 120.f;
+
+    for(int carCount = 1; carCount <= maxCars; ++carCount)
+    {
+        CarStates cars;
+        cars.Resize(carCount);
+        for(int i = 0; i < carCount; ++i)
+        {
+            cars.AssignCar(i, 0x100 + i, Vector{1000.f * i, 0, 0});
+            cars.SetHitbox(i, Hitboxes[i % static_cast<int>(HitboxType::MAX)]);
+            cars.forward[i] = {1, 0, 0};
+            cars.right[i] = {0, 1, 0};
+            cars.up[i] = {0, 0, 1};
+            cars.bOnGround[i] = i % 2 == 0;
+        }
+
+        ResetSmoothing smoothing;
+        steady_clock::time_point startTime = steady_clock::now();
+        for(int frame = 0; frame < frames; ++frame)
+        {
+            for(int i = 0; i < carCount; ++i)
+            {
+                cars.velocity[i] = Vector{1000.f + frame % 500, 200.f * i, 0};
+                cars.angularVelocity[i] = Vector{0, 0, (frame % 11) * .5f - 2.5f};
+            }
+            UpdateResetValues(cars, 92.75f, deltaTime, smoothing);
+        }
+        float frameNanoseconds = duration_cast<duration<float, std::nano>>(steady_clock::now() - startTime).count() / frames;
+
+        //Keeps the filters from being optimized away
+        volatile float sink = cars.smoothedForward[carCount - 1].X;
+        (void)sink;
+
+        printf("%d cars: %.1fns per frame, %.1fns per car\n", carCount, frameNanoseconds, frameNanoseconds / carCount);
+    }
+    return 0;
+}
@@ -0,0 +1,279 @@
+#include "Replay.h"
+#include "SessionStats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+//Headless tests for the core. Checks the stat accumulators and car slots, then replays every session in the corpus
+//Usage: CoreTests <corpus folder> <timing baseline file> [bless] [baseline]
+//  bless     overwrites the recorded outputs with this build's
+//  baseline  saves this run's timings as the new baseline
+//Timings depend on the machine, so the baseline is kept next to the build and written by the first run
+//They are only checked in optimized builds. A debug build prints them and checks outputs alone
+
+namespace
+{
+    constexpr float outputTolerance = .01f; //How far replayed outputs can drift from the recorded ones
+    constexpr float maxRegression = 25.f;   //Percent a stage's p99 time can grow over the baseline
+    constexpr float minRegression = .5f;    //Microseconds. Anything smaller is clock noise
+
+#ifdef NDEBUG
+    constexpr bool bCheckTiming = true;
+#else
+    constexpr bool bCheckTiming = false;
+#endif
+
+    bool IsNear(double value, double expected)
+    {
+        return std::abs(value - expected) < 1e-4;
+    }
+
+    bool CheckSessionStats()
+    {
+        bool bPassed = true;
+        auto Check = [&bPassed](bool bCondition, const char* description)
+        {
+            if(!bCondition)
+            {
+                printf("SessionStats: %s\n", description);
+                bPassed = false;
+            }
+        };
+
+        RunningStat stat;
+        for(float value : {2.f, 4.f, 4.f, 4.f, 5.f, 5.f, 7.f, 9.f})
+        {
+            stat.Add(value);
+        }
+        Check(stat.count == 8, "running stat count");
+        Check(IsNear(stat.mean, 5), "running stat mean");
+        Check(IsNear(stat.StdDev(), sqrt(32. / 7.)), "running stat sample standard deviation");
+        Check(stat.minValue == 2.f && stat.maxValue == 9.f, "running stat range");
+
+        FixedHistogram histogram{0, 120};
+        histogram.Add(-5);
+        histogram.Add(15);
+        histogram.Add(500);
+        Check(histogram.bins[0] == 1 && histogram.bins[1] == 1 && histogram.bins[STATS_HISTOGRAM_BINS - 1] == 1, "out of range values clamp to the end bins");
+        Check(histogram.total == 3 && histogram.GetLargestBin() == 1, "histogram totals");
+
+        //One second balanced, then the ball hits the floor
+        SessionStats stats;
+        constexpr float deltaTime = 1.f / 120.f;
+        for(int i = 0; i < 120; ++i)
+        {
+            stats.Update(deltaTime, 10, -5, true, false);
+        }
+        stats.AddTouch();
+        stats.AddTouch();
+        stats.Update(deltaTime, 0, 0, false, true);
+        Check(stats.dribbleDuration.count == 1, "dribble ends when the ball hits the floor");
+        Check(std::abs(stats.balancedTime - 1.f) < 1e-3f, "balanced time");
+        Check(IsNear(stats.forwardOffset.mean, 10) && IsNear(stats.lateralOffset.mean, -5), "balance offsets");
+        Check(IsNear(stats.touchesPerDribble.mean, 2), "touches per dribble");
+
+        printf("SessionStats: %s\n", bPassed ? "passed" : "FAILED");
+        return bPassed;
+    }
+
+    bool CheckCarStates()
+    {
+        bool bPassed = true;
+        auto Check = [&bPassed](bool bCondition, const char* description)
+        {
+            if(!bCondition)
+            {
+                printf("CarStates: %s\n", description);
+                bPassed = false;
+            }
+        };
+
+        //Three cars, then the middle one leaves and the last one moves down a slot
+        CarStates cars;
+        cars.Resize(3);
+        for(int i = 0; i < 3; ++i)
+        {
+            Check(cars.AssignCar(i, 0x100 + i, Vector{1000.f * i, 0, 0}), "first frame cars are new");
+            cars.SetHitbox(i, Hitboxes[i]);
+            cars.forward[i] = {1, 0, 0};
+            cars.right[i] = {0, 1, 0};
+            cars.up[i] = {0, 0, 1};
+        }
+        UpdateResetValues(cars, 92.75f, 1.f / 120.f, ResetSmoothing());
+        const Vector smoothedForward = cars.smoothedForward[2];
+        const Vector roofOffset = cars.roofOffset[2];
+
+        cars.Resize(std::max(cars.Count(), 2));
+        Check(!cars.AssignCar(0, 0x100, Vector{0, 0, 0}), "same car in the same slot keeps its history");
+        Check(!cars.AssignCar(1, 0x102, Vector{2000, 0, 0}), "car that moved down a slot keeps its history");
+        cars.Resize(2);
+        Check(cars.address[1] == 0x102 && cars.bSmoothingStarted[1], "moved car's smoothing carried over");
+        Check(cars.smoothedForward[1].X == smoothedForward.X && cars.roofOffset[1].Z == roofOffset.Z, "moved car's filters and hitbox carried over");
+        Check(cars.AssignCar(1, 0x103, Vector{0, 0, 0}) && !cars.bSmoothingStarted[1], "a new car starts fresh");
+
+        cars.location[0] = {0, 0, 17};
+        cars.location[1] = {2000, 0, 17};
+        UpdateBallDistances(cars, Vector{0, 0, 150});
+        Check(IsInDribbleRange(cars, 0) && !IsInDribbleRange(cars, 1) && !IsInDribbleRange(cars, -1), "dribble range");
+
+        printf("CarStates: %s\n", bPassed ? "passed" : "FAILED");
+        return bPassed;
+    }
+
+    bool RunCorpus(const std::filesystem::path& folder, const std::filesystem::path& baselinePath, bool bUpdateGolden, bool bSaveBaseline)
+    {
+        std::vector<std::filesystem::path> paths;
+        std::error_code error;
+        for(const auto& entry : std::filesystem::directory_iterator(folder, error))
+        {
+            if(entry.path().extension() == ".dtrp")
+            {
+                paths.push_back(entry.path());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+        if(paths.empty())
+        {
+            printf("No replays found in %s\n", folder.string().c_str());
+            return false;
+        }
+
+        //Every file replays on its own thread. The core keeps no shared state, so nothing needs locking
+        std::vector<std::future<ReplayResult>> results;
+        for(const auto& path : paths)
+        {
+            results.push_back(std::async(std::launch::async, [path, bUpdateGolden]()
+            {
+                ReplaySession session;
+                ReplayResult result;
+                if(session.Load(path.string()))
+                {
+                    result = RunReplay(session, outputTolerance, bUpdateGolden);
+                    if(bUpdateGolden && !session.Save(path.string()))
+                    {
+                        result.mismatchCount = 1;
+                        result.firstMismatch = "could not save the new outputs";
+                    }
+                }
+                result.name = path.filename().string();
+                return result;
+            }));
+        }
+
+        bool bPassed = true;
+        std::vector<float> stageTimes[static_cast<int>(ReplayStage::MAX)];
+        for(auto& future : results)
+        {
+            ReplayResult result = future.get();
+            if(!result.bLoaded)
+            {
+                printf("%s: could not load\n", result.name.c_str());
+                bPassed = false;
+                continue;
+            }
+
+            if(result.mismatchCount > 0)
+            {
+                printf("%s: %d mismatches in %d frames. First at %s\n", result.name.c_str(), result.mismatchCount, result.frameCount, result.firstMismatch.c_str());
+                bPassed = false;
+            }
+            else
+            {
+                printf("%s: %d frames %s\n", result.name.c_str(), result.frameCount, bUpdateGolden ? "updated" : "match");
+            }
+
+            for(int stage = 0; stage < static_cast<int>(ReplayStage::MAX); ++stage)
+            {
+                stageTimes[stage].insert(stageTimes[stage].end(), result.stageTimes[stage].begin(), result.stageTimes[stage].end());
+            }
+        }
+
+        //Compare each stage's p99 against the baseline from an earlier build on this machine
+        float baselineP99[static_cast<int>(ReplayStage::MAX)] = {};
+        bool bHasBaseline = false;
+        {
+            std::ifstream baselineFile(baselinePath);
+            std::string stageName;
+            float p50, p99;
+            while(baselineFile >> stageName >> p50 >> p99)
+            {
+                for(int stage = 0; stage < static_cast<int>(ReplayStage::MAX); ++stage)
+                {
+                    if(stageName == GetReplayStageName(static_cast<ReplayStage>(stage)))
+                    {
+                        baselineP99[stage] = p99;
+                        bHasBaseline = true;
+                    }
+                }
+            }
+        }
+
+        //Debug timings would make a useless baseline, so only optimized builds write one
+        bSaveBaseline = bCheckTiming && (bSaveBaseline || !bHasBaseline);
+        std::ofstream newBaselineFile;
+        if(bSaveBaseline)
+        {
+            newBaselineFile.open(baselinePath, std::ios::trunc);
+        }
+
+        for(int stage = 0; stage < static_cast<int>(ReplayStage::MAX); ++stage)
+        {
+            const char* stageName = GetReplayStageName(static_cast<ReplayStage>(stage));
+            float p50 = GetPercentile(stageTimes[stage], .5f);
+            float p99 = GetPercentile(stageTimes[stage], .99f);
+            printf("%s: p50 %.3fus, p99 %.3fus", stageName, p50, p99);
+
+            float allowedP99 = std::max(baselineP99[stage] * (1 + maxRegression / 100), baselineP99[stage] + minRegression);
+            if(bCheckTiming && !bSaveBaseline && baselineP99[stage] > 0 && p99 > allowedP99)
+            {
+                printf(" REGRESSED from p99 %.3fus", baselineP99[stage]);
+                bPassed = false;
+            }
+            printf("\n");
+
+            if(newBaselineFile.is_open())
+            {
+                newBaselineFile << stageName << " " << p50 << " " << p99 << "\n";
+            }
+        }
+
+        if(bSaveBaseline)
+        {
+            printf("Saved timing baseline to %s\n", baselinePath.string().c_str());
+        }
+        else if(!bCheckTiming)
+        {
+            printf("Timings not checked in a debug build\n");
+        }
+        printf("Replays: %s\n", bPassed ? "passed" : "FAILED");
+        return bPassed;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 3)
+    {
+        printf("Usage: CoreTests <corpus folder> <timing baseline file> [bless] [baseline]\n");
+        return 2;
+    }
+
+    bool bUpdateGolden = false;
+    bool bSaveBaseline = false;
+    for(int i = 3; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        bUpdateGolden |= option == "bless";
+        bSaveBaseline |= option == "baseline";
+    }
+
+    bool bPassed = CheckSessionStats();
+    bPassed &= CheckCarStates();
+    bPassed &= RunCorpus(argv[1], argv[2], bUpdateGolden, bSaveBaseline);
+    return bPassed ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+#include "Replay.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+//Writes the synthetic sessions in Corpus. Only needed when the replay format changes
+//Inputs are scripted car and ball motion. Outputs come from running the core once, same as an in-game recording
+//Usage: MakeReplayCorpus <corpus folder>
+
+namespace
+{
+    constexpr float frameTime = 1.f / 120.f;
+    constexpr float ballRadius = 92.75f;
+
+    struct ScriptedCar
+    {
+        uint64_t address;
+        HitboxType hitbox;
+        Vector location;
+        float yaw;
+        float speed;
+        float verticalSpeed;
+        bool bOnGround;
+    };
+
+    void AddFrame(ReplaySession& session, const std::vector<ScriptedCar>& scriptedCars, int frameIndex, Vector ballLocation, Vector ballVelocity)
+    {
+        ReplayFrame frame = {};
+        //Frame times wobble a little, like they do in game
+        frame.deltaTime = frameTime + (frameIndex % 3) * .0005f;
+        frame.smoothing = ResetSmoothing();
+        frame.ballLocation = ballLocation;
+        frame.ballVelocity = ballVelocity;
+        frame.ballRadius = ballRadius;
+        frame.localCarIndex = 0;
+        frame.firstCar = static_cast<uint32_t>(session.cars.size());
+        frame.carCount = static_cast<uint32_t>(scriptedCars.size());
+        session.frames.push_back(frame);
+
+        for(const ScriptedCar& scripted : scriptedCars)
+        {
+            const Vector forward = {cosf(scripted.yaw), sinf(scripted.yaw), 0};
+            const HitboxData& hitbox = Hitboxes[static_cast<int>(scripted.hitbox)];
+
+            ReplayCar car = {};
+            car.address = scripted.address;
+            car.location = scripted.location;
+            car.velocity = forward * scripted.speed + Vector{0, 0, scripted.verticalSpeed};
+            car.forward = forward;
+            car.right = {-forward.Y, forward.X, 0};
+            car.up = {0, 0, 1};
+            car.roofOffset = {hitbox.offsetForward, 0, hitbox.GetRoofHeight()};
+            car.bOnGround = scripted.bOnGround;
+            session.cars.push_back(car);
+        }
+    }
+
+    //Fills in the angular velocity from the change in yaw, then moves the car along its velocity
+    void StepCar(ReplaySession& session, ScriptedCar& car, int carSlot, float yawRate)
+    {
+        ReplayCar& recorded = session.cars[session.frames.back().firstCar + carSlot];
+        recorded.angularVelocity = {0, 0, yawRate};
+
+        car.yaw += yawRate * frameTime;
+        car.location += Vector{cosf(car.yaw), sinf(car.yaw), 0} * (car.speed * frameTime);
+        car.location.Z += car.verticalSpeed * frameTime;
+    }
+
+    //One Octane accelerating from a stop while weaving left and right with the ball on its roof
+    ReplaySession MakeGroundTurns()
+    {
+        ReplaySession session;
+        session.settings.maxFlickDistance = 1250;
+
+        std::vector<ScriptedCar> cars = {{0x1000, HitboxType::Octane, Vector{0, 0, 17}, 0, 0, 0, true}};
+        for(int frameIndex = 0; frameIndex < 240; ++frameIndex)
+        {
+            ScriptedCar& car = cars[0];
+            car.speed = std::min(car.speed + 1400 * frameTime, 1800.f);
+            Vector ballLocation = car.location + Vector{cosf(car.yaw), sinf(car.yaw), 0} * 15 + Vector{0, 0, 150};
+            AddFrame(session, cars, frameIndex, ballLocation, Vector{cosf(car.yaw), sinf(car.yaw), 0} * car.speed);
+            StepCar(session, car, 0, 3.f * sinf(frameIndex * .05f));
+        }
+        return session;
+    }
+
+    //A Dominus jumps, floats, and lands while the ball falls away behind it
+    ReplaySession MakeAerial()
+    {
+        ReplaySession session;
+        session.settings.maxFlickDistance = 1250;
+
+        std::vector<ScriptedCar> cars = {{0x2000, HitboxType::Dominus, Vector{0, 0, 17}, .5f, 1200, 0, true}};
+        Vector ballLocation = {0, 0, 160};
+        Vector ballVelocity = {1200 * cosf(.5f), 1200 * sinf(.5f), 0};
+        for(int frameIndex = 0; frameIndex < 240; ++frameIndex)
+        {
+            ScriptedCar& car = cars[0];
+            car.bOnGround = frameIndex < 30 || car.location.Z <= 17;
+            if(frameIndex == 30)
+            {
+                car.verticalSpeed = 600;
+            }
+            else if(!car.bOnGround)
+            {
+                car.verticalSpeed -= 650 * frameTime;
+            }
+            if(car.location.Z < 17)
+            {
+                car.location.Z = 17;
+                car.verticalSpeed = 0;
+            }
+
+            AddFrame(session, cars, frameIndex, ballLocation, ballVelocity);
+            StepCar(session, car, 0, 0);
+
+            ballVelocity.X *= .99f;
+            ballVelocity.Z -= 650 * frameTime;
+            ballLocation += ballVelocity * frameTime;
+            ballLocation.Z = std::max(ballLocation.Z, ballRadius);
+        }
+        return session;
+    }
+
+    //Three cars with different hitboxes. An opponent in the last slot dribbles, then the middle car leaves,
+    //which compacts the dribbler into a new slot before it flicks the ball away
+    ReplaySession MakeCarsLeaving()
+    {
+        ReplaySession session;
+        session.settings.maxFlickDistance = 1250;
+
+        std::vector<ScriptedCar> cars =
+        {
+            {0x3000, HitboxType::Octane, Vector{-2000,  0,    17}, 0,     800, 0, true},
+            {0x3100, HitboxType::Plank,  Vector{600,    1500, 17}, 3.1f,  300, 0, true},
+            {0x3200, HitboxType::Merc,   Vector{1200,   0,    17}, 1.57f, 700, 0, true},
+        };
+        Vector ballLocation;
+        Vector ballVelocity;
+        for(int frameIndex = 0; frameIndex < 240; ++frameIndex)
+        {
+            if(frameIndex == 120)
+            {
+                cars.erase(cars.begin() + 1);
+            }
+
+            //Ball rides on the dribbler's roof until the flick
+            ScriptedCar& dribbler = cars.back();
+            if(frameIndex < 150)
+            {
+                ballLocation = dribbler.location + Vector{0, 0, 150};
+                ballVelocity = Vector{cosf(dribbler.yaw), sinf(dribbler.yaw), 0} * dribbler.speed;
+            }
+            else if(frameIndex == 150)
+            {
+                ballVelocity = Vector{cosf(dribbler.yaw), sinf(dribbler.yaw), 0} * 2500 + Vector{0, 0, 900};
+            }
+
+            AddFrame(session, cars, frameIndex, ballLocation, ballVelocity);
+            for(int slot = 0; slot < static_cast<int>(cars.size()); ++slot)
+            {
+                StepCar(session, cars[slot], slot, slot == 0 ? 0.f : .8f);
+            }
+
+            if(frameIndex >= 150)
+            {
+                ballVelocity.Z -= 650 * frameTime;
+                ballLocation += ballVelocity * frameTime;
+                ballLocation.Z = std::max(ballLocation.Z, ballRadius);
+            }
+        }
+        return session;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 2)
+    {
+        printf("Usage: MakeReplayCorpus <corpus folder>\n");
+        return 2;
+    }
+
+    std::filesystem::path folder = argv[1];
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+
+    struct NamedSession
+    {
+        const char* name;
+        ReplaySession session;
+    };
+    NamedSession sessions[] =
+    {
+        {"GroundTurns.dtrp", MakeGroundTurns()},
+        {"Aerial.dtrp",      MakeAerial()},
+        {"CarsLeaving.dtrp", MakeCarsLeaving()},
+    };
+
+    bool bPassed = true;
+    for(NamedSession& named : sessions)
+    {
+        RunReplay(named.session, 0, true);
+        std::filesystem::path path = folder / named.name;
+        if(!named.session.Save(path.string()))
+        {
+            printf("Failed to write %s\n", path.string().c_str());
+            bPassed = false;
+            continue;
+        }
+        printf("Wrote %d frames to %s\n", static_cast<int>(named.session.frames.size()), path.string().c_str());
+    }
+    return bPassed ? 0 : 1;
+}
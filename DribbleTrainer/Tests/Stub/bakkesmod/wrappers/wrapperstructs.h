@@ -0,0 +1,40 @@
+#pragma once
+#include <cmath>
+
+//Stand-in for the SDK's Vector so the headless core can be built and tested without BakkesMod
+//Only covers what CarStates, Replay, and SessionStats use. Must stay the same size and layout as the SDK's, since replays store it raw
+struct Vector
+{
+    float X = 0;
+    float Y = 0;
+    float Z = 0;
+
+    Vector() {}
+    Vector(float x, float y, float z) : X(x), Y(y), Z(z) {}
+
+    Vector operator+(const Vector& other) const { return Vector(X + other.X, Y + other.Y, Z + other.Z); }
+    Vector operator-(const Vector& other) const { return Vector(X - other.X, Y - other.Y, Z - other.Z); }
+    Vector operator*(float scale) const { return Vector(X * scale, Y * scale, Z * scale); }
+    Vector operator/(float scale) const { return Vector(X / scale, Y / scale, Z / scale); }
+    Vector& operator+=(const Vector& other) { X += other.X; Y += other.Y; Z += other.Z; return *this; }
+    Vector& operator-=(const Vector& other) { X -= other.X; Y -= other.Y; Z -= other.Z; return *this; }
+    Vector& operator*=(float scale) { X *= scale; Y *= scale; Z *= scale; return *this; }
+    Vector& operator/=(float scale) { X /= scale; Y /= scale; Z /= scale; return *this; }
+
+    float magnitude() const { return sqrtf(X * X + Y * Y + Z * Z); }
+    void normalize()
+    {
+        float length = magnitude();
+        if(length > 0) { *this /= length; }
+    }
+    Vector getNormalized() const
+    {
+        Vector result = *this;
+        result.normalize();
+        return result;
+    }
+
+    static float dot(const Vector& a, const Vector& b) { return a.X * b.X + a.Y * b.Y + a.Z * b.Z; }
+};
+
+static_assert(sizeof(Vector) == 12, "Replays store Vector as three floats");
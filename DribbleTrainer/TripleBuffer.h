@@ -0,0 +1,38 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+//Lock-free single producer / single consumer triple buffer
+//The writer fills GetWriteBuffer() then calls Publish()
+//The reader calls Update() then reads GetReadBuffer(). Neither side ever waits on the other
+template<typename T>
+class TripleBuffer
+{
+    static constexpr uint8_t IndexMask = 0x3;
+    static constexpr uint8_t FreshBit  = 0x4;
+
+    T buffers[3];
+
+    //Index of the buffer between writer and reader. FreshBit is set when it holds unread data
+    std::atomic<uint8_t> middle{2};
+
+    uint8_t writeIndex = 0; //Only touched by the writer
+    uint8_t readIndex  = 1; //Only touched by the reader
+
+public:
+    //Writer
+    T& GetWriteBuffer() { return buffers[writeIndex]; }
+    void Publish()
+    {
+        writeIndex = middle.exchange(writeIndex | FreshBit, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    //Reader - returns true if a newer buffer was swapped in
+    bool Update()
+    {
+        if(!(middle.load(std::memory_order_relaxed) & FreshBit)) { return false; }
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+    const T& GetReadBuffer() const { return buffers[readIndex]; }
+};